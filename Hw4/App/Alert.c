@@ -0,0 +1,183 @@
+/*--------------- A l e r t . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Threshold alert rules, checked against every decoded reading. Rules
+for the same message type are chained, so a reading only visits the
+rules that can apply to it. Each rule remembers which nodes are in
+alert; a node leaves alert once the value is back past the threshold
+by the hysteresis, so a noisy value doesn't flood the output.
+
+A rule matches a node when (srcAddr & nodeMask) == (nodeAddr & nodeMask);
+a nodeMask of 0 matches every node.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Change a rule's state only when its line is sent
+*/
+
+#include "includes.h"
+#include "Payload.h"
+#include "Alert.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define NumAddrs 256
+
+// Defaults: below freezing, and wind over 50.0
+#define FreezeThreshold 0
+#define FreezeHysteresis 1
+#define GaleThreshold 500
+#define GaleHysteresis 50
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_INT08U nodeAddr;
+  CPU_INT08U nodeMask;
+  CPU_INT08U msgType;
+  CPU_INT08U field;         // Index into Reading.field
+  CPU_INT08U cmp;           // AlertBelow or AlertAbove
+  CPU_INT08U next;          // Next rule for the same msgType
+  CPU_INT32S threshold;
+  CPU_INT32S hysteresis;
+} AlertRule;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static AlertRule rules[MaxRules];
+static CPU_INT08U numRules;
+static CPU_INT08U firstRule[IDMsg+1];            // Chain head per msgType
+static CPU_INT08U inAlert[MaxRules][NumAddrs/8]; // Bit per node per rule
+
+/*--------------- A l e r t I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Clear the rule table and load the default rules.
+*/
+void AlertInit(void)
+{
+  numRules = 0;
+  Mem_Set(firstRule,NoRule,sizeof(firstRule));
+  Mem_Clr(inAlert,sizeof(inAlert));
+  
+  AlertAddRule(0,0,TempMsg,0,AlertBelow,FreezeThreshold,FreezeHysteresis);
+  AlertAddRule(0,0,WindMsg,0,AlertAbove,GaleThreshold,GaleHysteresis);
+}
+
+/*--------------- A l e r t A d d R u l e ( ) ---------------*/
+
+/*
+PURPOSE
+Add a rule to the table.
+
+INPUT PARAMETERS
+nodeAddr   - node address to match
+nodeMask   - address bits that must match (0 = any node)
+msgType    - the message type
+field      - which field of the reading to test
+cmp        - AlertBelow or AlertAbove
+threshold  - alert when the value crosses this
+hysteresis - how far back past the threshold before the alert clears
+
+RETURN VALUE
+The rule number, or NoRule if the table is full.
+*/
+CPU_INT08U AlertAddRule(CPU_INT08U nodeAddr,CPU_INT08U nodeMask,
+                        CPU_INT08U msgType,CPU_INT08U field,CPU_INT08U cmp,
+                        CPU_INT32S threshold,CPU_INT32S hysteresis)
+{
+  AlertRule *rule;
+  
+  if(numRules >= MaxRules || msgType > IDMsg || field >= MaxFields)
+    return NoRule;
+  
+  rule = &rules[numRules];
+  rule->nodeAddr = nodeAddr;
+  rule->nodeMask = nodeMask;
+  rule->msgType = msgType;
+  rule->field = field;
+  rule->cmp = cmp;
+  rule->threshold = threshold;
+  rule->hysteresis = hysteresis;
+  
+  //push onto the front of this type's chain
+  rule->next = firstRule[msgType];
+  firstRule[msgType] = numRules;
+  
+  return numRules++;
+}
+
+/*--------------- A l e r t C h e c k ( ) ---------------*/
+
+/*
+PURPOSE
+Run a reading through the rules for its message type. A rule only
+raises or clears an alert when its line fits in alertBfr; otherwise
+the node's next reading tries again.
+
+INPUT PARAMETERS
+reading  - the decoded reading
+alertBfr - receives one line per alert raised or cleared, or an empty
+           string if nothing changed (at least AlertBfrSize bytes)
+*/
+void AlertCheck(Reading *reading,CPU_CHAR *alertBfr)
+{
+  AlertRule *rule;
+  CPU_INT08U r;
+  CPU_INT08U bit;
+  CPU_INT08U *state;
+  CPU_INT32S value;
+  CPU_BOOLEAN active;
+  CPU_BOOLEAN change;
+  CPU_CHAR *p = alertBfr;
+  CPU_CHAR *end = alertBfr + AlertBfrSize - AlertLineSize;
+  
+  *p = '\0';
+  if(reading->numFields == 0 || reading->msgType > IDMsg)
+    return;
+  
+  for(r=firstRule[reading->msgType];r!=NoRule;r=rule->next)
+  {
+    rule = &rules[r];
+    if((reading->srcAddr & rule->nodeMask) != (rule->nodeAddr & rule->nodeMask) ||
+       rule->field >= reading->numFields)
+      continue;
+    
+    value = reading->field[rule->field];
+    state = &inAlert[r][reading->srcAddr>>3];
+    bit = 1<<(reading->srcAddr&7);
+    active = (*state & bit) != 0;
+    
+    //raise on crossing the threshold, clear past the hysteresis band
+    if(rule->cmp == AlertBelow)
+      change = active ? value >= rule->threshold + rule->hysteresis
+                      : value < rule->threshold;
+    else
+      change = active ? value <= rule->threshold - rule->hysteresis
+                      : value > rule->threshold;
+    
+    //with no room for the line, leave the state as it is so the
+    //node's next reading makes the change again
+    if(!change || p >= end)
+      continue;
+    
+    *state ^= bit;
+    p += sprintf(p," %s*** %s NODE %d: %s = %ld, %s%s %ld\n",
+                 active ? "" : "\a",
+                 active ? "CLEAR" : "ALERT",
+                 reading->srcAddr,
+                 MetricName(MetricOf(reading->msgType,rule->field)),
+                 (long)value,
+                 active ? "no longer " : "",
+                 rule->cmp == AlertBelow ? "below" : "above",
+                 (long)rule->threshold);
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef __alert__
+#define __alert__
+/*--------------- A l e r t . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Alert.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+#include "Payload.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Size of the rule table
+#ifndef MaxRules
+#define MaxRules 8
+#endif
+#define NoRule 0xFF
+
+// Comparators
+#define AlertBelow 0    // Alert while value < threshold
+#define AlertAbove 1    // Alert while value > threshold
+
+// Size of the alert text buffer (room for a few alerts per reading)
+#define AlertLineSize 80
+#define AlertBfrSize (3*AlertLineSize)
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void AlertInit(void);
+CPU_INT08U AlertAddRule(CPU_INT08U nodeAddr,CPU_INT08U nodeMask,
+                        CPU_INT08U msgType,CPU_INT08U field,CPU_INT08U cmp,
+                        CPU_INT32S threshold,CPU_INT32S hysteresis);
+void AlertCheck(Reading *reading,CPU_CHAR *alertBfr);
+
+#endif
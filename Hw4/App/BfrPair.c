@@ -8,6 +8,8 @@ multitasking.
 
 CHANGES
 02-24-2013 dwt -  Created
+10-19-2026 dwt - Added PutBfrEmpty()
+10-19-2026 dwt - Added PutBfrCount()
 */
 #include "includes.h"
 #include "Buffer.h"
@@ -94,6 +96,38 @@ CPU_BOOLEAN PutBfrClosed(BfrPair *bfrPair)
   return BfrClosed(&bfrPair->buffers[bfrPair->putBfrNum]);
 }
 
+/*--------------- P u t B f r E m p t y ( ) ---------------
+
+PURPOSE
+Test whether or not the put buffer holds any bytes.
+
+INPUT PARAMETERS
+bfrPair - buffer pair address
+
+RETURN VALUE
+TRUE if nothing has been added to the put buffer, otherwise FALSE
+*/
+CPU_BOOLEAN PutBfrEmpty(BfrPair *bfrPair)
+{
+  return BfrEmpty(&bfrPair->buffers[bfrPair->putBfrNum]);
+}
+
+/*--------------- P u t B f r C o u n t ( ) ---------------
+
+PURPOSE
+Count the bytes added to the put buffer.
+
+INPUT PARAMETERS
+bfrPair - buffer pair address
+
+RETURN VALUE
+The number of bytes in the put buffer
+*/
+CPU_INT16U PutBfrCount(BfrPair *bfrPair)
+{
+  return bfrPair->buffers[bfrPair->putBfrNum].putIndex;
+}
+
 /*--------------- G e t B f r C l o s e d ( ) ---------------
 
 PURPOSE
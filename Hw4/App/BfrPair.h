@@ -32,6 +32,8 @@ void PutBfrReset(BfrPair *bfrPair);
 CPU_INT08U *PutBfrAddr(BfrPair *bfrPair);
 CPU_INT08U *GetBfrAddr(BfrPair *bfrPair);
 CPU_BOOLEAN PutBfrClosed(BfrPair *bfrPair);
+CPU_BOOLEAN PutBfrEmpty(BfrPair *bfrPair);
+CPU_INT16U PutBfrCount(BfrPair *bfrPair);
 CPU_BOOLEAN GetBfrClosed(BfrPair *bfrPair);
 void ClosePutBfr(BfrPair *bfrPair);
 void OpenGetBfr (BfrPair *bfrPair);
@@ -0,0 +1,299 @@
+/*--------------- C a l e n d a r . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Convert DATE/TIME stamps to and from seconds since the epoch, and keep
+a wall clock set from the most recent stamp heard.
+
+A stamp arrives as a packed 32 bit word, byte swapped on the wire:
+
+   31   27 26   21 20          9 8     5 4   0
+  | hour  | minute |    year    | month | day |
+
+Days before each month come from a table, and the days before Jan 1
+of a year come from a small cache keyed by year, so a conversion is a
+few table lookups. A cache miss is still constant time. PayloadTask
+and the report task share the cache and the wall clock, so entries and
+the clock are copied in and out whole with the scheduler locked.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Reject days past the end of the month, bad hours and minutes
+10-19-2026 dwt - Copy year entries and the clock whole, reject dates past 2106
+*/
+
+#include "includes.h"
+#include "Payload.h"
+#include "Calendar.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define NoYear 0xFFFF
+#define DaysPerYear 365
+#define HoursPerDay 24
+#define MinutesPerHour 60
+#define MaxEpoch 0xFFFFFFFFUL   // 06:28:15 Feb 7 2106
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_INT16U year;          // NoYear if the entry is empty
+  CPU_BOOLEAN leap;
+  CPU_INT32U daysBefore;    // Days from the epoch to Jan 1
+} YearEntry;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+// Days before the first of each month in a common year (index 1-12)
+static const CPU_INT16U daysBeforeMonth[13] =
+  {0,0,31,59,90,120,151,181,212,243,273,304,334};
+
+static YearEntry yearCache[CalCacheSize];
+
+static CPU_BOOLEAN clockSet;
+static CPU_INT32U clockEpoch;   // Epoch time at clockTick
+static OS_TICK clockTick;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void LookupYear(CPU_INT16U year,YearEntry *entry);
+static CPU_INT08U DaysInMonth(YearEntry *entry,CPU_INT08U month);
+
+/*--------------- C a l I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Empty the year cache and forget the wall clock.
+*/
+void CalInit(void)
+{
+  CPU_INT08U i;
+  
+  for(i=0;i<CalCacheSize;i++)
+    yearCache[i].year = NoYear;
+  clockSet = FALSE;
+}
+
+/*--------------- C a l F r o m W i r e ( ) ---------------*/
+
+/*
+PURPOSE
+Byte swap a stamp as it arrives in a DATE/TIME packet into the packed
+layout above.
+*/
+CPU_INT32U CalFromWire(CPU_INT32U wire)
+{
+  return (wire<<EndBytePosition) |
+         ((wire<<MiddleBytePosition)&(ByteMask<<(EndBytePosition-MiddleBytePosition))) |
+         ((wire>>MiddleBytePosition)&(ByteMask<<MiddleBytePosition)) |
+         (wire>>EndBytePosition);
+}
+
+/*--------------- C a l U n p a c k ( ) ---------------*/
+
+/*
+PURPOSE
+Split a packed stamp into its fields.
+
+INPUT PARAMETERS
+packed - the stamp, already through CalFromWire()
+date   - receives the fields
+*/
+void CalUnpack(CPU_INT32U packed,CalDate *date)
+{
+  date->month  = (packed>>MonthPosition) & ((1<<MonthLength)-1);
+  date->day    = (packed>>DayPosition) & ((1<<DayLength)-1);
+  date->year   = (packed>>YearPosition) & ((1<<YearLength)-1);
+  date->hour   = (packed>>HourPosition) & ((1<<HourLength)-1);
+  date->minute = (packed>>MinutePosition) & ((1<<MinuteLength)-1);
+}
+
+/*--------------- C a l D a y O f Y e a r ( ) ---------------*/
+
+/*
+PURPOSE
+Return the day of the year, Jan 1 = 1.
+*/
+CPU_INT16U CalDayOfYear(CalDate *date)
+{
+  YearEntry entry;
+  CPU_INT08U month = (date->month >= 1 && date->month <= 12) ? date->month : 1;
+  
+  LookupYear(date->year,&entry);
+  return daysBeforeMonth[month] + (entry.leap && month > 2) + date->day;
+}
+
+/*--------------- C a l T o E p o c h ( ) ---------------*/
+
+/*
+PURPOSE
+Convert a date to seconds since the epoch.
+
+RETURN VALUE
+Seconds since the epoch, or 0 for a date before the epoch or past
+what 32 bits hold, or with an out of range month, day, hour or minute.
+Feb 29 is only taken in a leap year.
+*/
+CPU_INT32U CalToEpoch(CalDate *date)
+{
+  YearEntry entry;
+  CPU_INT64U secs;
+  
+  if(date->year < EpochYear || date->month < 1 || date->month > 12 ||
+     date->hour >= HoursPerDay || date->minute >= MinutesPerHour)
+    return 0;
+  
+  LookupYear(date->year,&entry);
+  if(date->day < 1 || date->day > DaysInMonth(&entry,date->month))
+    return 0;
+  
+  //the 12 bit year runs to 4095, well past 2106
+  secs = (CPU_INT64U)(entry.daysBefore + CalDayOfYear(date) - 1) * SecsPerDay +
+         (CPU_INT32U)date->hour * SecsPerHour +
+         (CPU_INT32U)date->minute * SecsPerMinute;
+  if(secs > MaxEpoch)
+    return 0;
+  
+  return (CPU_INT32U)secs;
+}
+
+/*--------------- C a l F r o m E p o c h ( ) ---------------*/
+
+/*
+PURPOSE
+Convert seconds since the epoch back to a date.
+*/
+void CalFromEpoch(CPU_INT32U epoch,CalDate *date)
+{
+  YearEntry entry;
+  CPU_INT32U days = epoch / SecsPerDay;
+  CPU_INT32U secs = epoch % SecsPerDay;
+  CPU_INT16U yday;
+  CPU_INT08U month;
+  
+  //365 days a year is never an overestimate; step back at most once
+  date->year = EpochYear + days/365;
+  LookupYear(date->year,&entry);
+  if(entry.daysBefore > days)
+    LookupYear(--date->year,&entry);
+  
+  yday = days - entry.daysBefore;
+  for(month=12;month>1;month--)
+    if(yday >= daysBeforeMonth[month] + (entry.leap && month > 2))
+      break;
+  
+  date->month = month;
+  date->day = yday - daysBeforeMonth[month] - (entry.leap && month > 2) + 1;
+  date->hour = secs / SecsPerHour;
+  date->minute = (secs % SecsPerHour) / SecsPerMinute;
+}
+
+/*--------------- C a l S e t C l o c k ( ) ---------------*/
+
+/*
+PURPOSE
+Set the wall clock from a stamp that was just received.
+*/
+void CalSetClock(CPU_INT32U epoch)
+{
+  OS_ERR osErr;
+  
+  OSSchedLock(&osErr);
+  clockTick = OSTimeGet(&osErr);
+  clockEpoch = epoch;
+  clockSet = TRUE;
+  OSSchedUnlock(&osErr);
+}
+
+/*--------------- C a l C l o c k S e t ( ) ---------------*/
+
+CPU_BOOLEAN CalClockSet(void)
+{
+  return clockSet;
+}
+
+/*--------------- C a l N o w ( ) ---------------*/
+
+/*
+PURPOSE
+Return the wall clock in seconds since the epoch (0 until set).
+*/
+CPU_INT32U CalNow(void)
+{
+  CPU_BOOLEAN set;
+  CPU_INT32U epoch;
+  OS_TICK tick;
+  OS_ERR osErr;
+  
+  //PayloadTask may be setting the clock
+  OSSchedLock(&osErr);
+  set = clockSet;
+  epoch = clockEpoch;
+  tick = clockTick;
+  OSSchedUnlock(&osErr);
+  
+  if(!set)
+    return 0;
+  
+  return epoch + (OSTimeGet(&osErr) - tick) / OSCfg_TickRate_Hz;
+}
+
+/*--------------- D a y s I n M o n t h ( ) ---------------*/
+
+/*
+PURPOSE
+Return the number of days in a month of the given year.
+
+INPUT PARAMETERS
+entry - the year's cache entry
+month - 1-12
+*/
+static CPU_INT08U DaysInMonth(YearEntry *entry,CPU_INT08U month)
+{
+  CPU_INT16U next = (month < 12) ? daysBeforeMonth[month+1] : DaysPerYear;
+  
+  return next - daysBeforeMonth[month] + (entry->leap && month == 2);
+}
+
+/*--------------- L o o k u p Y e a r ( ) ---------------*/
+
+/*
+PURPOSE
+Find a year in the cache, filling its entry on a miss.
+
+INPUT PARAMETERS
+year  - the year
+entry - receives a copy of the year's entry
+*/
+static void LookupYear(CPU_INT16U year,YearEntry *entry)
+{
+  YearEntry *cached = &yearCache[year % CalCacheSize];
+  CPU_INT32U y;
+  OS_ERR osErr;
+  
+  //a higher priority task may be refilling the entry
+  OSSchedLock(&osErr);
+  *entry = *cached;
+  OSSchedUnlock(&osErr);
+  
+  if(entry->year == year)
+    return;
+  
+  //leap days in [EpochYear, year) by the Gregorian rule
+  y = year - 1;
+  entry->year = year;
+  entry->leap = (year%4 == 0 && year%100 != 0) || year%400 == 0;
+  entry->daysBefore = (CPU_INT32U)(year - EpochYear) * 365 +
+                      (y/4 - y/100 + y/400) -
+                      ((EpochYear-1)/4 - (EpochYear-1)/100 + (EpochYear-1)/400);
+  
+  OSSchedLock(&osErr);
+  *cached = *entry;
+  OSSchedUnlock(&osErr);
+}
@@ -0,0 +1,56 @@
+#ifndef __calendar__
+#define __calendar__
+/*--------------- C a l e n d a r . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Calendar.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Epoch times count seconds from 00:00 Jan 1 of this year
+#define EpochYear 1970
+
+#define SecsPerMinute 60
+#define SecsPerHour 3600
+#define SecsPerDay 86400UL
+
+// Years remembered in the year cache
+#ifndef CalCacheSize
+#define CalCacheSize 4
+#endif
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_INT16U year;
+  CPU_INT08U month;     // 1-12
+  CPU_INT08U day;       // 1-31
+  CPU_INT08U hour;
+  CPU_INT08U minute;
+} CalDate;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void CalInit(void);
+CPU_INT32U CalFromWire(CPU_INT32U wire);
+void CalUnpack(CPU_INT32U packed,CalDate *date);
+CPU_INT16U CalDayOfYear(CalDate *date);
+CPU_INT32U CalToEpoch(CalDate *date);
+void CalFromEpoch(CPU_INT32U epoch,CalDate *date);
+void CalSetClock(CPU_INT32U epoch);
+CPU_BOOLEAN CalClockSet(void);
+CPU_INT32U CalNow(void);
+
+#endif
@@ -0,0 +1,93 @@
+/*--------------- C o m m a n d . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Carry out the diagnostic commands sent to the gateway as CmdMsg
+packets. Anything slow is only requested here and done later by a
+low priority task, so PayloadTask is never held up.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added CmdIsrDump
+10-19-2026 dwt - Added CmdLatDump
+10-19-2026 dwt - Added CmdOutputMode
+10-19-2026 dwt - Added CmdShedPolicy
+10-19-2026 dwt - Added CmdErrorMode
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Payload.h"
+#include "TxQueue.h"
+#include "Error.h"
+#include "Command.h"
+#include "Trace.h"
+#include "IsrHist.h"
+#include "Latency.h"
+#include "Log.h"
+
+/*--------------- R u n C o m m a n d ( ) ---------------*/
+
+/*
+PURPOSE
+Carry out one command.
+
+INPUT PARAMETERS
+code - the command code
+arg  - the command argument, if the command takes one
+*/
+void RunCommand(CPU_INT08U code,CPU_INT08U arg)
+{
+  switch(code)
+  {
+  case CmdTraceOff:
+    TraceEnable(FALSE);
+    break;
+  case CmdTraceOn:
+    TraceEnable(TRUE);
+    break;
+  case CmdTraceDump:
+    TraceRequestDump();
+    break;
+  case CmdIsrDump:
+    IsrHistRequestDump();
+    break;
+  case CmdLatDump:
+    LatencyRequestDump();
+    break;
+  case CmdOutputMode:
+    if(arg > OutputSummary)
+    {
+      Log2(TxHigh," *** BAD ARGUMENT %d TO COMMAND %d\n",arg,code);
+      return;
+    }
+    SetOutputMode(arg);
+    break;
+  case CmdShedPolicy:
+    if(arg > ShedSummary)
+    {
+      Log2(TxHigh," *** BAD ARGUMENT %d TO COMMAND %d\n",arg,code);
+      return;
+    }
+    SetShedPolicy(arg);
+    break;
+  case CmdErrorMode:
+    if(arg > ErrAggregate)
+    {
+      Log2(TxHigh," *** BAD ARGUMENT %d TO COMMAND %d\n",arg,code);
+      return;
+    }
+    SetErrorMode(arg);
+    break;
+  default:
+    Log1(TxHigh," *** UNKNOWN COMMAND %d\n",code);
+    return;
+  }
+  
+  Log1(TxBulk," COMMAND %d OK\n",code);
+}
@@ -0,0 +1,43 @@
+#ifndef __command__
+#define __command__
+/*--------------- C o m m a n d . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Command.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added CmdIsrDump
+10-19-2026 dwt - Added CmdLatDump
+10-19-2026 dwt - Added CmdOutputMode
+10-19-2026 dwt - Added CmdShedPolicy
+10-19-2026 dwt - Added CmdErrorMode
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Command codes carried by a CmdMsg
+#define CmdTraceOff 0       // Stop the context switch tracer
+#define CmdTraceOn 1        // Start it with an empty ring
+#define CmdTraceDump 2      // Send the trace ring
+#define CmdIsrDump 3        // Send and clear the SerialISR histograms
+#define CmdLatDump 4        // Send and clear the packet latency histograms
+#define CmdOutputMode 5     // Set the output mode to arg: OutputAll or
+                            // OutputSummary
+#define CmdShedPolicy 6     // Set the overload policy to arg: ShedDropOldest,
+                            // ShedDropNew or ShedSummary
+#define CmdErrorMode 7      // Set the error reporting mode to arg:
+                            // ErrEveryFrame or ErrAggregate
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void RunCommand(CPU_INT08U code,CPU_INT08U arg);
+
+#endif
@@ -11,31 +11,139 @@ Provide error methods to other modules
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Tally errors by class, rate-limit the reports
+10-19-2026 dwt - Log errors instead of formatting them in PayloadTask
 */
 
 #include "includes.h"
+#include "SerIODriver.h"
 #include "Error.h"
+#include "Log.h"
 
-void HandleErr(CPU_INT08U *msgBfr,CPU_INT08S len)
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define ErrLineSize 224
+
+// Error code to tally index
+#define ErrClass(err) (-(err) - 1)
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static CPU_INT08U errorMode = ErrorMode;
+static CPU_INT32U errCounts[NumErrClasses];   // Errors this interval
+static CPU_INT16U secsLeft = ErrReportSec;    // Until the next summary
+static CPU_CHAR errLine[ErrLineSize];         // Summary being built
+
+static const CPU_CHAR *errNames[NumErrClasses] =
 {
+  "PREAMBLE 1",
+  "PREAMBLE 2",
+  "PREAMBLE 3",
+  "CHECKSUM",
+  "SIZE",
+  "OVERSIZE",
+  "UNKNOWN TYPE"
+};
+
+/*--------------- H a n d l e E r r ( ) ---------------*/
+
+/*
+PURPOSE
+Report a bad frame on the high priority lane. Only a log entry is made
+here; the log task formats it later. In ErrAggregate mode the error is
+only tallied, and logged just for the first error of its class in the
+current interval; ErrorReport() covers the rest.
+
+INPUT PARAMETERS
+len - the error code
+*/
+void HandleErr(CPU_INT08S len)
+{
+  if(len < -NumErrClasses || len >= 0)
+    return;
+  
+  if(errCounts[ErrClass(len)]++ > 0 && errorMode == ErrAggregate)
+    return;
+  
   switch(len)
   {
   case P1Err:
-    sprintf((CPU_CHAR *) msgBfr, " \a*** ERROR: Bad Preamble Byte %d\n", -1*P1Err);
+    Log1(TxHigh," \a*** ERROR: Bad Preamble Byte %d\n", -1*P1Err);
     return;
   case P2Err:
-    sprintf((CPU_CHAR *) msgBfr, " \a*** ERROR: Bad Preamble Byte %d\n", -1*P2Err);
+    Log1(TxHigh," \a*** ERROR: Bad Preamble Byte %d\n", -1*P2Err);
     return;
   case P3Err:
-    sprintf((CPU_CHAR *) msgBfr, " \a*** ERROR: Bad Preamble Byte %d\n", -1*P3Err);
+    Log1(TxHigh," \a*** ERROR: Bad Preamble Byte %d\n", -1*P3Err);
     return;
   case CheckErr:
-    sprintf((CPU_CHAR *) msgBfr, " \a*** ERROR: Checksum error\n");
+    Log0(TxHigh," \a*** ERROR: Checksum error\n");
     return;
   case SizeErr:
-    sprintf((CPU_CHAR *) msgBfr, " \a*** ERROR: Bad Packet Size\n");
+    Log0(TxHigh," \a*** ERROR: Bad Packet Size\n");
+    return;
+  case OversizeErr:
+    Log0(TxHigh," \a*** ERROR: Packet Too Large\n");
+    return;
+  case UnknownErr:
+    Log0(TxHigh," \a*** ERROR: Unknown Message Type\n");
     return;
   default:
     return;
   }
-}
\ No newline at end of file
+}
+
+/*--------------- E r r o r R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. Every ErrReportSec seconds,
+send one line on the high priority lane with the count of each error
+class seen in the interval, then start a new interval. Nothing is sent
+for a clean interval.
+*/
+void ErrorReport(void)
+{
+  OS_ERR osErr;
+  CPU_INT32U counts[NumErrClasses];
+  CPU_CHAR *p = errLine;
+  CPU_INT08U i;
+  CPU_BOOLEAN any = FALSE;
+  
+  if(--secsLeft > 0)
+    return;
+  secsLeft = ErrReportSec;
+  
+  //take the interval's counts away from PayloadTask in one piece
+  OSSchedLock(&osErr);
+  Mem_Copy(counts,errCounts,sizeof(counts));
+  Mem_Clr(errCounts,sizeof(errCounts));
+  OSSchedUnlock(&osErr);
+  
+  p += sprintf(p," \a*** ERRORS LAST %d S:",ErrReportSec);
+  for(i=0;i<NumErrClasses;i++)
+    if(counts[i] > 0)
+    {
+      p += sprintf(p," %s %lu",errNames[i],(unsigned long) counts[i]);
+      any = TRUE;
+    }
+  sprintf(p,"\n");
+  
+  if(any)
+    PutLaneMsg(TxHigh,errLine);
+}
+
+/*--------------- S e t E r r o r M o d e ( ) ---------------*/
+
+/*
+PURPOSE
+Select how bad frames are reported. Called by RunCommand() for
+CmdErrorMode.
+
+INPUT PARAMETERS
+mode - ErrEveryFrame or ErrAggregate
+*/
+void SetErrorMode(CPU_INT08U mode)
+{
+  errorMode = mode;
+}
@@ -14,6 +14,9 @@ exported from the module "Error.c"
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Added error classes and the aggregate reporting mode
+10-19-2026 dwt - HandleErr() logs through the deferred logger
+10-19-2026 dwt - CmdErrorMode sets the mode at run time
 */
 
 /*----- c o n s t a n t   d e f i n a t i o n s -----*/
@@ -22,8 +25,29 @@ CHANGES
 #define P3Err -3
 #define CheckErr -4
 #define SizeErr -5
+#define OversizeErr -6    // Length field larger than a payload buffer
+#define UnknownErr -7     // Valid frame of an unknown message type
+#define NumErrClasses 7
+
+// Reporting modes
+#define ErrEveryFrame 0   // One line per bad frame
+#define ErrAggregate 1    // Tally; one line when a class first appears
+                          // and one summary line per interval
+
+// If not already defined, aggregate errors. CmdErrorMode changes the
+// mode at run time.
+#ifndef ErrorMode
+#define ErrorMode ErrAggregate
+#endif
+
+// Seconds between error summaries
+#ifndef ErrReportSec
+#define ErrReportSec 10
+#endif
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
-void HandleErr(CPU_INT08U *msgBfr,CPU_INT08S len);
+void HandleErr(CPU_INT08S len);
+void ErrorReport(void);
+void SetErrorMode(CPU_INT08U mode);
 
 #endif
\ No newline at end of file
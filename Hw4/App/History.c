@@ -0,0 +1,333 @@
+/*--------------- H i s t o r y . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Keep a short history of (time stamp, value) samples for every node
+and metric, and answer history queries with a binary reply packet.
+
+Each ring keeps its newest sample in full. Older samples are stored as
+the step from the sample before them, newest last, so the ring is read
+backwards from the newest sample. A step that fits in a byte each for
+time and value takes one 16 bit slot:
+
+    dt (0..254 units) | dv (-128..127)
+
+Anything bigger takes four slots, written oldest first:
+
+    dt (16 bit units) | dv high half | dv low half | EscMark
+
+Overwriting the oldest slots never corrupts newer samples since the
+ring is only ever walked from the newest end.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Count readings from nodes past HistNodes
+*/
+
+#include "includes.h"
+#include "Payload.h"
+#include "NodeTable.h"
+#include "History.h"
+#include "PktParser.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define EscMark 0xFF00      // dt byte 0xFF marks an escaped sample
+#define EscSlots 4
+#define MaxShortDt 0xFE
+#define MaxLongDt 0xFFFF
+
+// Reply frame layout
+#define ReplyHeaderLen 7    // Preamble, length, dst, src, type
+#define ReplyFixedLen 3     // Node, metric, count
+#define ReplySampleLen 8    // Time stamp and value, 4 bytes each
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_INT32U newestTime;    // Newest sample, in HistTickUnits
+  CPU_INT32S newestValue;
+  CPU_INT16U head;          // Next slot to write
+  CPU_INT16U used;          // Slots holding steps
+  CPU_BOOLEAN empty;
+  CPU_INT16U slots[HistSlots];
+} HistRing;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static HistRing rings[HistNodes][NumMetrics];
+static CPU_INT32U unrecorded;      // Readings from slots past HistNodes
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void RingPut(HistRing *ring,CPU_INT16U slot);
+static CPU_INT16U RingAt(HistRing *ring,CPU_INT16U back);
+static void PutWord32(CPU_INT08U *p,CPU_INT32U word);
+
+/*--------------- H i s t o r y I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Empty every ring and zero the unrecorded count.
+*/
+void HistoryInit(void)
+{
+  CPU_INT08U node;
+  CPU_INT08U metric;
+  
+  unrecorded = 0;
+  for(node=0;node<HistNodes;node++)
+    for(metric=0;metric<NumMetrics;metric++)
+    {
+      rings[node][metric].head = 0;
+      rings[node][metric].used = 0;
+      rings[node][metric].empty = TRUE;
+    }
+}
+
+/*--------------- H i s t o r y A d d ( ) ---------------*/
+
+/*
+PURPOSE
+Append a reading's fields to its node's rings. The node's slot must
+already have been claimed with NodeSlot().
+
+INPUT PARAMETERS
+reading - the decoded reading
+*/
+void HistoryAdd(Reading *reading)
+{
+  HistRing *ring;
+  CPU_INT08U slot;
+  CPU_INT08U metric;
+  CPU_INT08U i;
+  CPU_INT32U now;
+  CPU_INT32U dt;
+  CPU_INT32S dv;
+  OS_ERR osErr;
+  
+  if(reading->numFields == 0)
+    return;
+  
+  slot = FindNodeSlot(reading->srcAddr);
+  if(slot == NoSlot)
+    return;
+  if(slot >= HistNodes)
+  {
+    unrecorded++;
+    return;
+  }
+  
+  now = OSTimeGet(&osErr) / HistTickUnit;
+  
+  for(i=0;i<reading->numFields;i++)
+  {
+    metric = MetricOf(reading->msgType,i);
+    if(metric == NoMetric)
+      continue;
+    
+    ring = &rings[slot][metric];
+    
+    if(!ring->empty)
+    {
+      //record the step from the previous newest sample
+      dt = now - ring->newestTime;
+      dv = reading->field[i] - ring->newestValue;
+      
+      if(dt <= MaxShortDt && dv >= -128 && dv <= 127)
+        RingPut(ring,(CPU_INT16U)((dt<<ByteSize) | (dv & ByteMask)));
+      else
+      {
+        //a gap too long for 16 bits reads back as the longest gap
+        RingPut(ring,(CPU_INT16U)(dt > MaxLongDt ? MaxLongDt : dt));
+        RingPut(ring,(CPU_INT16U)((CPU_INT32U)dv>>16));
+        RingPut(ring,(CPU_INT16U)dv);
+        RingPut(ring,EscMark);
+      }
+    }
+    
+    ring->newestTime = now;
+    ring->newestValue = reading->field[i];
+    ring->empty = FALSE;
+  }
+}
+
+/*--------------- H i s t o r y G e t ( ) ---------------*/
+
+/*
+PURPOSE
+Read back the newest samples of one node and metric, newest first.
+
+INPUT PARAMETERS
+srcAddr - the node address
+metric  - the metric number
+count   - most samples wanted
+ticks   - receives each sample's time stamp in OS ticks
+values  - receives each sample's value
+
+RETURN VALUE
+The number of samples returned.
+*/
+CPU_INT08U HistoryGet(CPU_INT08U srcAddr,CPU_INT08U metric,CPU_INT08U count,
+                      OS_TICK *ticks,CPU_INT32S *values)
+{
+  HistRing *ring;
+  CPU_INT08U slot = FindNodeSlot(srcAddr);
+  CPU_INT08U n;
+  CPU_INT16U back;
+  CPU_INT16U step;
+  CPU_INT32U time;
+  CPU_INT32S value;
+  
+  if(slot == NoSlot || slot >= HistNodes || metric >= NumMetrics)
+    return 0;
+  
+  ring = &rings[slot][metric];
+  if(ring->empty || count == 0)
+    return 0;
+  
+  time = ring->newestTime;
+  value = ring->newestValue;
+  back = 0;
+  
+  for(n=0;;)
+  {
+    ticks[n] = (OS_TICK)time * HistTickUnit;
+    values[n] = value;
+    if(++n >= count || back >= ring->used)
+      break;
+    
+    //undo one step
+    step = RingAt(ring,back++);
+    if((step & EscMark) != EscMark)
+    {
+      time -= step>>ByteSize;
+      value -= (CPU_INT08S)(step & ByteMask);
+    }
+    else
+    {
+      if(back + EscSlots-1 > ring->used)
+        break;
+      value -= (CPU_INT32S)(((CPU_INT32U)RingAt(ring,back+1)<<16) |
+                            RingAt(ring,back));
+      time -= RingAt(ring,back+2);
+      back += EscSlots-1;
+    }
+  }
+  
+  return n;
+}
+
+/*--------------- H i s t o r y U n r e c o r d e d ( ) ---------------*/
+
+/*
+PURPOSE
+Report how many readings had a node slot but no history rings.
+*/
+CPU_INT32U HistoryUnrecorded(void)
+{
+  return unrecorded;
+}
+
+/*--------------- H i s t o r y R e p l y ( ) ---------------*/
+
+/*
+PURPOSE
+Answer a history query with a framed binary packet:
+
+  03 EF AF len dst src HistoryMsg node metric n
+  n * (time stamp in ticks, value), both 32 bit big endian
+  checksum
+
+INPUT PARAMETERS
+frame   - where to build the reply (at least 256 bytes)
+dstAddr - the node that asked
+node    - the node whose history is wanted
+metric  - the metric number
+count   - most samples wanted
+
+RETURN VALUE
+The length of the reply frame.
+*/
+CPU_INT16U HistoryReply(CPU_INT08U *frame,CPU_INT08U dstAddr,CPU_INT08U node,
+                        CPU_INT08U metric,CPU_INT08U count)
+{
+  static OS_TICK ticks[HistMaxReply];
+  static CPU_INT32S values[HistMaxReply];
+  CPU_INT08U n;
+  CPU_INT08U i;
+  CPU_INT08U len;
+  CPU_INT08U checksum = 0;
+  CPU_INT08U *p;
+  
+  if(count > HistMaxReply)
+    count = HistMaxReply;
+  
+  n = HistoryGet(node,metric,count,ticks,values);
+  len = ReplyHeaderLen + ReplyFixedLen + n*ReplySampleLen + 1;
+  
+  p = frame;
+  *p++ = P1Char;
+  *p++ = P2Char;
+  *p++ = P3Char;
+  *p++ = len;
+  *p++ = dstAddr;
+  *p++ = DEST_ADDR;
+  *p++ = HistoryMsg;
+  *p++ = node;
+  *p++ = metric;
+  *p++ = n;
+  for(i=0;i<n;i++)
+  {
+    PutWord32(p,ticks[i]);
+    PutWord32(p+4,(CPU_INT32U)values[i]);
+    p += ReplySampleLen;
+  }
+  
+  //make the XOR of the whole frame zero
+  for(i=0;i<len-1;i++)
+    checksum ^= frame[i];
+  *p = checksum;
+  
+  return len;
+}
+
+/*--------------- R i n g P u t ( ) ---------------*/
+
+static void RingPut(HistRing *ring,CPU_INT16U slot)
+{
+  ring->slots[ring->head] = slot;
+  if(++ring->head >= HistSlots)
+    ring->head = 0;
+  if(ring->used < HistSlots)
+    ring->used++;
+}
+
+/*--------------- R i n g A t ( ) ---------------*/
+
+/*
+PURPOSE
+Read the slot "back" places before the newest one.
+*/
+static CPU_INT16U RingAt(HistRing *ring,CPU_INT16U back)
+{
+  CPU_INT16U i = (ring->head + HistSlots - 1 - back) % HistSlots;
+  
+  return ring->slots[i];
+}
+
+/*--------------- P u t W o r d 3 2 ( ) ---------------*/
+
+static void PutWord32(CPU_INT08U *p,CPU_INT32U word)
+{
+  p[0] = (CPU_INT08U)(word>>24);
+  p[1] = (CPU_INT08U)(word>>16);
+  p[2] = (CPU_INT08U)(word>>8);
+  p[3] = (CPU_INT08U)word;
+}
@@ -0,0 +1,56 @@
+#ifndef __history__
+#define __history__
+/*--------------- H i s t o r y . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "History.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Time stamps in whole seconds
+10-19-2026 dwt - Count readings from nodes past HistNodes
+*/
+#include "includes.h"
+#include "Payload.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Node slots with history (the first HistNodes of NodeSlots); readings
+// from later nodes are counted and not recorded
+#ifndef HistNodes
+#define HistNodes 8
+#endif
+
+// 16 bit ring slots per node and metric; a sample takes one slot, or
+// four when its time or value step is too big for a byte
+#ifndef HistSlots
+#define HistSlots 64
+#endif
+
+// Time stamp resolution in OS ticks. One second lets a one byte step
+// span up to 254 s, so periodic telemetry takes one slot a sample; at
+// finer units most steps would need the four slot escape.
+#ifndef HistTickUnit
+#define HistTickUnit OS_CFG_TICK_RATE_HZ
+#endif
+
+// Most samples in one reply (keeps the frame under 256 bytes)
+#define HistMaxReply 30
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void HistoryInit(void);
+void HistoryAdd(Reading *reading);
+CPU_INT08U HistoryGet(CPU_INT08U srcAddr,CPU_INT08U metric,CPU_INT08U count,
+                      OS_TICK *ticks,CPU_INT32S *values);
+CPU_INT32U HistoryUnrecorded(void);
+CPU_INT16U HistoryReply(CPU_INT08U *frame,CPU_INT08U dstAddr,CPU_INT08U node,
+                        CPU_INT08U metric,CPU_INT08U count);
+
+#endif
@@ -0,0 +1,291 @@
+/*--------------- I d l e . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Sleep in the idle task instead of spinning, and account for it.
+
+App_OS_IdleTaskHook() calls IdleSleep(), which sets PRIMASK and then
+executes WFI. A pending interrupt still wakes the core, but is not
+taken until PRIMASK is cleared, so the hook can first read how long it
+slept from SysTick and which interrupt is pending. The SysTick counter
+keeps running in sleep mode, unlike the DWT cycle counter.
+
+With TicklessIdle set, the hook also suppresses the 1 kHz tick while
+nothing is due: SysTick is reprogrammed to fire at the earliest kernel
+deadline, and the ticks that passed are handed to OSTimeTick() on wake,
+so delays, timeouts and OSTickCtr stay right.
+
+The report task sends the share of time asleep and the wakeups by
+source every IdleReportSec seconds. Sleeping also slows the idle
+counter the statistic task measures CPU usage with, so with
+IdleSleepEn set this report, not OSStatTaskCPUUsage, gives the true
+utilization.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the tickless idle mode
+10-19-2026 dwt - Keep the tick phase across a sleep that reached its
+                 deadline
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Idle.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define IdleLineSize 96
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static CPU_INT64U asleep;                     // SysTick counts spent asleep
+static CPU_INT32U tickCounts;                 // SysTick counts per OS tick
+static CPU_INT32U wakes[NumWakeSrcs];         // Wakeups by source
+static OS_TICK lastTick;                      // OS tick of the last report
+static CPU_INT16U secsLeft = IdleReportSec;   // Until the next report
+static CPU_CHAR idleLine[IdleLineSize];
+
+static const CPU_CHAR *wakeNames[NumWakeSrcs] = { "TICK", "UART", "OTHER" };
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void CountWake(void);
+#if TicklessIdle
+static OS_TICK NextDeadline(void);
+static OS_TICK TicklessSleep(OS_TICK idleTicks);
+#endif
+
+/*--------------- I d l e S l e e p ( ) ---------------*/
+
+/*
+PURPOSE
+Sleep until the next interrupt, then record the time asleep and the
+interrupt that ended it. With TicklessIdle set, and no deadline due
+within the next two ticks, the tick is suppressed until the earliest
+deadline instead.
+*/
+void IdleSleep(void)
+{
+#if IdleSleepEn
+  CPU_INT32U before;
+  CPU_INT32U after;
+#if TicklessIdle
+  OS_TICK idleTicks;
+  OS_TICK missed = 0;
+  OS_ERR osErr;
+#endif
+  
+  IdleIntDis();
+  
+  //the first call sees the reload the BSP set up
+  if(tickCounts == 0)
+    tickCounts = SYST_RVR + 1;
+  
+#if TicklessIdle
+  idleTicks = NextDeadline();
+  if(idleTicks >= 2 && !(SCB_ICSR & PENDSTSET))
+    missed = TicklessSleep(idleTicks);
+  else
+#endif
+  {
+    //sleep never outlasts one tick, as the tick itself wakes the core,
+    //so the counter wraps at most once
+    before = SYST_CVR;
+    IdleWfi();
+    after = SYST_CVR;
+    
+    //SysTick counts down and reloads from SYST_RVR
+    if(after <= before)
+      asleep += before - after;
+    else
+      asleep += before + (tickCounts - after);
+  }
+  
+  CountWake();
+  
+  IdleIntEn();
+  
+#if TicklessIdle
+  //hand the kernel the ticks that were suppressed
+  if(missed > 0)
+  {
+    OSSchedLock(&osErr);
+    while(missed-- > 0)
+      OSTimeTick();
+    OSSchedUnlock(&osErr);
+  }
+#endif
+#endif
+}
+
+/*--------------- C o u n t W a k e ( ) ---------------*/
+
+/*
+PURPOSE
+Record which interrupt ended a sleep. Called with PRIMASK set, so the
+interrupt is still pending.
+*/
+static void CountWake(void)
+{
+  if(NVIC_ISPR1 & USART2PEND)
+    wakes[WakeUsart]++;
+  else if(SCB_ICSR & PENDSTSET)
+    wakes[WakeTick]++;
+  else
+    wakes[WakeOther]++;
+}
+
+#if TicklessIdle
+/*--------------- N e x t D e a d l i n e ( ) ---------------*/
+
+/*
+PURPOSE
+Find how many ticks away the earliest kernel deadline is: a delay or
+pend timeout on the tick wheel, or the next timer task update. Reads
+the V3.0x tick wheel directly. Called with PRIMASK set from the idle
+task, so the tick task has no ticks left to process.
+
+RETURN VALUE
+Ticks to the earliest deadline, at most what one SysTick period holds
+*/
+static OS_TICK NextDeadline(void)
+{
+  OS_TICK next = SystMax / tickCounts;
+  OS_TCB *tcb;
+  OS_TICK_SPOKE_IX i;
+  
+  for(i = 0;i < OSCfg_TickWheelSize;i++)
+    for(tcb = OSCfg_TickWheel[i].FirstPtr;tcb != NULL;tcb = tcb->TickNextPtr)
+      if(tcb->TickCtrMatch - OSTickCtr < next)
+        next = tcb->TickCtrMatch - OSTickCtr;
+  
+#if OS_CFG_TMR_EN > 0u
+  if(OSTmrUpdateCtr < next)
+    next = OSTmrUpdateCtr;
+#endif
+  
+  return next;
+}
+
+/*--------------- T i c k l e s s S l e e p ( ) ---------------*/
+
+/*
+PURPOSE
+Stretch the current SysTick period to end at the deadline, sleep, then
+put the normal period back. If the deadline was reached, the pending
+SysTick interrupt supplies the last tick, and the counts since it are
+carried into the restored period; if another interrupt came first,
+the partial tick is. Either way the tick phase is kept.
+
+INPUT PARAMETERS
+idleTicks - ticks to the deadline, at least 2
+
+RETURN VALUE
+Whole ticks that passed without a SysTick interrupt
+*/
+static OS_TICK TicklessSleep(OS_TICK idleTicks)
+{
+  CPU_INT32U programmed;
+  CPU_INT32U remaining;
+  CPU_INT32U past;
+  CPU_INT32U csr;
+  OS_TICK ahead;
+  OS_TICK missed;
+  
+  //stop the counter and stretch what is left of this tick
+  SYST_CSR &= ~SYST_ENABLE;
+  programmed = SYST_CVR + tickCounts * (idleTicks - 1);
+  SYST_RVR = programmed - 1;
+  SYST_CVR = 0;
+  SYST_CSR |= SYST_ENABLE;
+  
+  IdleWfi();
+  
+  //reading CSR clears COUNTFLAG, so read it once
+  csr = SYST_CSR;
+  SYST_CSR = csr & ~SYST_ENABLE;
+  remaining = SYST_CVR;
+  
+  if((csr & SYST_COUNTFLAG) || remaining == 0)
+  {
+    //reached the deadline; the SysTick interrupt counts the last tick.
+    //The count reloaded and ran on until now, into the next tick, or
+    //past it if the wake was slow
+    past = (csr & SYST_COUNTFLAG) ? programmed - remaining : 0;
+    asleep += programmed;
+    missed = idleTicks - 1 + past / tickCounts;
+    SYST_RVR = tickCounts - past % tickCounts - 1;
+    SYST_CVR = 0;
+  }
+  else
+  {
+    //woken early; tick boundaries fall every tickCounts back from the
+    //deadline, so finish the current tick on its old schedule
+    asleep += programmed - remaining;
+    ahead = (remaining + tickCounts - 1) / tickCounts;
+    missed = idleTicks - ahead;
+    SYST_RVR = remaining - (ahead - 1) * tickCounts - 1;
+    SYST_CVR = 0;
+  }
+  
+  //the new count is taken on the first reload; later ones are normal
+  SYST_CSR |= SYST_ENABLE;
+  SYST_RVR = tickCounts - 1;
+  
+  return missed;
+}
+#endif
+
+/*--------------- I d l e R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. Every IdleReportSec seconds,
+send the share of the interval spent asleep, in hundredths of a
+percent, and the wakeups by source, then start a new interval.
+*/
+void IdleReport(void)
+{
+  OS_ERR osErr;
+  CPU_INT64U slept;
+  CPU_INT32U counts[NumWakeSrcs];
+  CPU_INT64U total;
+  OS_TICK now;
+  CPU_INT32U pct100;
+  CPU_CHAR *p = idleLine;
+  CPU_INT08U i;
+  CPU_SR_ALLOC();
+  
+  if(--secsLeft > 0)
+    return;
+  secsLeft = IdleReportSec;
+  
+  //the idle hook updates these with interrupts off
+  CPU_CRITICAL_ENTER();
+  slept = asleep;
+  asleep = 0;
+  for(i=0;i<NumWakeSrcs;i++)
+  {
+    counts[i] = wakes[i];
+    wakes[i] = 0;
+  }
+  CPU_CRITICAL_EXIT();
+  
+  now = OSTimeGet(&osErr);
+  total = (CPU_INT64U)(now - lastTick) * tickCounts;
+  lastTick = now;
+  pct100 = (total > 0) ? (CPU_INT32U)(slept * 10000 / total) : 0;
+  
+  p += sprintf(p," IDLE: ASLEEP %lu.%02lu%%, WAKES",
+                  (unsigned long)(pct100 / 100),(unsigned long)(pct100 % 100));
+  for(i=0;i<NumWakeSrcs;i++)
+    p += sprintf(p," %s %lu",wakeNames[i],(unsigned long) counts[i]);
+  sprintf(p,"\n");
+  
+  PutMsg(idleLine);
+}
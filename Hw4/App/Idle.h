@@ -0,0 +1,76 @@
+#ifndef __idle__
+#define __idle__
+/*--------------- I d l e . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Idle.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the tickless idle mode
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Sleep in the idle hook; 0 spins as before
+#ifndef IdleSleepEn
+#define IdleSleepEn 1
+#endif
+
+// Suppress the tick while nothing is due; needs IdleSleepEn
+#ifndef TicklessIdle
+#define TicklessIdle 0
+#endif
+
+// Seconds between idle reports
+#ifndef IdleReportSec
+#define IdleReportSec 10
+#endif
+
+// The core operations the idle hook uses. A host build replaces them
+// with stubs to drive the hook without the hardware.
+#ifndef IdleIntDis
+#define IdleIntDis() asm(" cpsid i")      // PRIMASK = 1
+#endif
+#ifndef IdleIntEn
+#define IdleIntEn() asm(" cpsie i")       // PRIMASK = 0
+#endif
+#ifndef IdleWfi
+#define IdleWfi() asm(" wfi")             // Sleep until an interrupt is pending
+#endif
+
+// SysTick and NVIC registers read to time the sleep and find the waker
+#ifndef SYST_RVR
+#define SYST_CSR (*((volatile CPU_INT32U *) 0xE000E010))  // SysTick control
+#define SYST_RVR (*((volatile CPU_INT32U *) 0xE000E014))  // SysTick reload
+#define SYST_CVR (*((volatile CPU_INT32U *) 0xE000E018))  // SysTick current
+#define SCB_ICSR (*((volatile CPU_INT32U *) 0xE000ED04))  // Interrupt control
+#define NVIC_ISPR1 (*((volatile CPU_INT32U *) 0xE000E204)) // IRQ 32-63 pending
+#endif
+#define SYST_ENABLE 0x00000001      // CSR: counter enabled
+#define SYST_COUNTFLAG 0x00010000   // CSR: counted to 0 since last read
+#define PENDSTSET 0x04000000    // ICSR: SysTick pending
+#define USART2PEND 0x00000040   // ISPR1: IRQ38 pending
+
+// Longest SysTick period
+#define SystMax 0x00FFFFFF
+
+// Wake sources
+#define WakeTick 0
+#define WakeUsart 1
+#define WakeOther 2
+#define NumWakeSrcs 3
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void IdleSleep(void);
+void IdleReport(void);
+
+#endif
@@ -11,12 +11,21 @@ PURPOSE
 Defines global variable "disableCnt" to track nested
 interrupt disables. 
 
+IntMask() and IntUnmask() mask by priority instead, through BASEPRI,
+and time the longest masked stretch.
+
 CHANGES
 02-10-2014  gpc - Updated for spring 2014 16.572 Program 3
+10-19-2026  dwt - Added priority masking with BASEPRI
 */
 
 // Level of nesting of interrupt disables.
-static CPU_INT16S disableCnt = 0;
+CPU_INT16S disableCnt = 0;
+
+// When the outermost IntMask() began, and the longest masked stretch.
+// Tasks can't switch while masked, so one start time is enough.
+static CPU_TS maskStart;
+static CPU_TS maskMax;
 
 /*--------------- I n t D i s ( ) ----------
 
@@ -43,3 +52,70 @@ void IntEn(void)
  	if (disableCnt == 0)
 		asm(" cpsie i");
 }
+
+/*--------------- I n t M a s k ( ) ----------
+
+PURPOSE
+Raise BASEPRI to IntMaskPrio, unless already masked at least that far.
+Nests: pass the value returned to the matching IntUnmask().
+
+RETURN VALUE
+The previous BASEPRI.
+*/
+
+CPU_INT32U IntMask(void)
+{
+	CPU_INT32U basepri = IntGetBasepri();
+
+	if (basepri == 0 || basepri > IntMaskPrio)
+	{
+		IntSetBasepri(IntMaskPrio);
+		if (basepri == 0)
+			maskStart = CPU_TS_Get32();
+	}
+	return basepri;
+}
+
+/*--------------- I n t U n m a s k ( ) ----------
+
+PURPOSE
+Restore BASEPRI, timing the masked stretch if this ends it.
+
+INPUT PARAMETERS
+basepri - the value IntMask() returned
+*/
+
+void IntUnmask(CPU_INT32U basepri)
+{
+	CPU_TS masked;
+
+	if (basepri == 0)
+	{
+		masked = CPU_TS_Get32() - maskStart;
+		if (masked > maskMax)
+			maskMax = masked;
+	}
+	IntSetBasepri(basepri);
+}
+
+/*--------------- I n t M a s k M a x G e t ( ) ----------
+
+RETURN VALUE
+The longest stretch masked by IntMask(), in CPU_TS counts.
+*/
+
+CPU_TS IntMaskMaxGet(void)
+{
+	return maskMax;
+}
+
+/*--------------- I n t M a s k M a x R e s e t ( ) ----------
+
+PURPOSE
+Start measuring the longest masked stretch again.
+*/
+
+void IntMaskMaxReset(void)
+{
+	maskMax = 0;
+}
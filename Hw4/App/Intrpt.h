@@ -12,14 +12,36 @@ Provides functions to enable and disable interrupts.
 
 CHANGES
 02-10-2014  gpc - Updated for spring 2014 16.572 Program 3
+10-19-2026  dwt - Added priority masking with BASEPRI
 */
 
 #include "CPU.h"
 
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// IntMask() holds off PendSV and every interrupt at this priority or
+// below (numerically greater or equal). Interrupts above it, the USART
+// among them, still run, so they must not touch what it protects.
+// STM32F1 implements the top 4 bits of each priority.
+#ifndef IntMaskPrio
+#define IntMaskPrio 0x40
+#endif
+
+// BASEPRI access. A host build replaces these with stubs.
+#ifndef IntGetBasepri
+#include <intrinsics.h>
+#define IntGetBasepri() __get_BASEPRI()
+#define IntSetBasepri(p) __set_BASEPRI(p)
+#endif
+
 // Level of nesting of interrupt disables.
 extern CPU_INT16S disableCnt;
 
 /*----- f u n c t i o n     p r o t o t y p e s -----*/
 void IntDis(void);
 void IntEn(void);
+CPU_INT32U IntMask(void);
+void IntUnmask(CPU_INT32U basepri);
+CPU_TS IntMaskMaxGet(void);
+void IntMaskMaxReset(void);
 #endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*--------------- I s r H i s t . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Log2 histograms of SerialISR's timing, in CPU_TS counts. The ISR adds
+to them directly with IsrHistAdd(). Duration runs from ISR entry to
+just before OSIntExit(). RX lag estimates how late each received byte
+is serviced: bytes arriving back to back are one byte time apart, so
+the earliest service seen in a run, carried forward a byte time at a
+time, bounds each arrival from above.
+
+RX lag is relative, not the true RXNE to entry latency, which needs an
+arrival stamp from a capture timer. It is the delay past the best
+serviced byte of the run, so a delay common to the whole run reads as
+zero, and the first byte of a run is not counted.
+
+A CmdIsrDump command has the report task send both histograms, with
+the longest time interrupts have been disabled since startup, and
+clear them. Together they show how close the ISR comes to missing a
+byte at a given baud rate and buffer size.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Latency histogram renamed RX lag, a relative estimate
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "IsrHist.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define IsrLineSize 48
+
+//----- g l o b a l    v a r i a b l e s -----
+
+CPU_INT32U isrRxLag[IsrBuckets];
+CPU_INT32U isrDuration[IsrBuckets];
+
+static volatile CPU_BOOLEAN dumpReq;   // Dump on the next poll
+static CPU_CHAR isrLine[IsrLineSize];
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void IsrHistSend(const CPU_CHAR *name,CPU_INT32U *hist);
+
+/*--------------- I s r H i s t R e q u e s t D u m p ( ) ---------------*/
+
+/*
+PURPOSE
+Ask for the histograms to be sent and cleared by the report task.
+*/
+void IsrHistRequestDump(void)
+{
+  dumpReq = TRUE;
+}
+
+/*--------------- I s r H i s t P o l l ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. If a dump was requested, send
+both histograms and the worst interrupt disable time.
+*/
+void IsrHistPoll(void)
+{
+  CPU_ERR cpuErr;
+  
+  if(!dumpReq)
+    return;
+  dumpReq = FALSE;
+  
+  sprintf(isrLine,"\n ISR HIST, TS AT %lu HZ\n",
+                  (unsigned long) CPU_TS_TmrFreqGet(&cpuErr));
+  PutMsg(isrLine);
+  
+  IsrHistSend("RX LAG",isrRxLag);
+  IsrHistSend("DURATION",isrDuration);
+  
+  sprintf(isrLine," INT DIS MAX %lu TS\n",
+                  (unsigned long) CPU_IntDisMeasMaxGet());
+  PutMsg(isrLine);
+}
+
+/*--------------- I s r H i s t S e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Send one line per non-empty bucket, giving the bucket's upper bound,
+and clear each bucket as it is read.
+
+INPUT PARAMETERS
+name - histogram name for the lines
+hist - the histogram
+*/
+static void IsrHistSend(const CPU_CHAR *name,CPU_INT32U *hist)
+{
+  CPU_INT32U count;
+  CPU_INT08U b;
+  CPU_SR_ALLOC();
+  
+  for(b=0;b<IsrBuckets;b++)
+  {
+    //the ISR may be adding to this bucket
+    CPU_CRITICAL_ENTER();
+    count = hist[b];
+    hist[b] = 0;
+    CPU_CRITICAL_EXIT();
+    
+    if(count == 0)
+      continue;
+    sprintf(isrLine,"  %s < 2^%u: %lu\n",name,(unsigned) b,(unsigned long) count);
+    PutMsg(isrLine);
+  }
+}
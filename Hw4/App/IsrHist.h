@@ -0,0 +1,42 @@
+#ifndef __isrhist__
+#define __isrhist__
+/*--------------- I s r H i s t . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "IsrHist.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Latency histogram renamed RX lag
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Bucket 0 counts times of 0, bucket b times from 2^(b-1) to 2^b - 1
+// CPU_TS counts
+#define IsrBuckets 33
+
+// Bucket of a time. CPU_CntLeadZeros() is a single CLZ on the M3.
+#define IsrBucket(t) (32 - CPU_CntLeadZeros(t))
+
+// Count one time into a histogram; cheap enough for every interrupt
+#define IsrHistAdd(hist,t) ((hist)[IsrBucket(t)]++)
+
+// SerialISR histograms, updated only by SerialISR
+extern CPU_INT32U isrRxLag[IsrBuckets];     // RX service past the best of
+                                            // its back to back run
+extern CPU_INT32U isrDuration[IsrBuckets];  // Entry to exit
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void IsrHistRequestDump(void);
+void IsrHistPoll(void);
+
+#endif
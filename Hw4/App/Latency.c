@@ -0,0 +1,210 @@
+/*--------------- L a t e n c y . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Per packet latency through the gateway, from the first preamble byte
+of a frame to the last byte of a message rendered from it. Four stamps
+are taken: ServiceRx() as it reads each preamble byte, ParsePkt() as it
+closes a good frame, PayloadTask() as it renders each message, and
+ServiceTx() as it hands the USART the message's last byte. The first
+two travel in the payload buffer and all three in the TX queue and
+lane, so ServiceTx() can time every stage at once.
+
+Each stage goes into a log2 histogram in LatNow() counts, bucketed as
+in IsrHist.c, along with its count, total and worst time since power
+up. Messages not rendered from a packet, reports and log entries among
+them, carry no stamps and are not timed.
+
+A CmdLatDump command has the report task send the histograms and clear
+them.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "IsrHist.h"
+#include "Latency.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define LatLineSize 48
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// One stage's times, updated only by ServiceTx()
+typedef struct
+{
+  CPU_INT32U hist[IsrBuckets];    // Since the last dump
+  CPU_INT32U count;               // Since power up
+  CPU_INT64U sum;
+  CPU_TS max;
+} LatStage;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static LatStage stages[NumLatStages];
+static volatile CPU_BOOLEAN dumpReq;   // Dump on the next poll
+static CPU_CHAR latLine[LatLineSize];
+
+static const CPU_CHAR *stageNames[NumLatStages] =
+{
+  "PARSE",
+  "RENDER",
+  "TX",
+  "TOTAL"
+};
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void LatAdd(CPU_INT08U stage,CPU_TS t);
+
+/*--------------- L a t e n c y D o n e ( ) ---------------*/
+
+/*
+PURPOSE
+Time every stage of a message whose last byte has just gone out.
+Called from ServiceTx().
+
+INPUT PARAMETERS
+stamps - the message's stamps
+*/
+void LatencyDone(LatStamps *stamps)
+{
+  CPU_TS now = LatNow();
+  
+  LatAdd(LatParse,stamps->parsed - stamps->rx);
+  LatAdd(LatRender,stamps->rendered - stamps->parsed);
+  LatAdd(LatTx,now - stamps->rendered);
+  LatAdd(LatTotal,now - stamps->rx);
+}
+
+/*--------------- L a t e n c y G e t ( ) ---------------*/
+
+/*
+PURPOSE
+Report one stage's times since power up.
+
+INPUT PARAMETERS
+stage - LatParse, LatRender, LatTx or LatTotal
+count - returns the number of messages timed
+avg   - returns the average time, LatNow() counts
+max   - returns the worst time, LatNow() counts
+*/
+void LatencyGet(CPU_INT08U stage,CPU_INT32U *count,
+                CPU_TS *avg,CPU_TS *max)
+{
+  LatStage *s = &stages[stage];
+  CPU_INT64U sum;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  *count = s->count;
+  sum = s->sum;
+  *max = s->max;
+  CPU_CRITICAL_EXIT();
+  
+  *avg = (*count > 0) ? (CPU_TS) (sum / *count) : 0;
+}
+
+/*--------------- L a t e n c y F r e q ( ) ---------------*/
+
+/*
+RETURN VALUE
+LatNow() counts per second.
+*/
+CPU_INT32U LatencyFreq(void)
+{
+  CPU_ERR cpuErr;
+  
+  return LatFreq(&cpuErr);
+}
+
+/*--------------- L a t e n c y N a m e ( ) ---------------*/
+
+/*
+RETURN VALUE
+The name of a stage, as the histogram lines give it.
+*/
+const CPU_CHAR *LatencyName(CPU_INT08U stage)
+{
+  return stageNames[stage];
+}
+
+/*--------------- L a t e n c y R e q u e s t D u m p ( ) ---------------*/
+
+/*
+PURPOSE
+Ask for the histograms to be sent and cleared by the report task.
+*/
+void LatencyRequestDump(void)
+{
+  dumpReq = TRUE;
+}
+
+/*--------------- L a t e n c y P o l l ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. If a dump was requested, send
+one line per non-empty bucket of each stage, giving the bucket's upper
+bound, and clear each bucket as it is read.
+*/
+void LatencyPoll(void)
+{
+  CPU_INT32U count;
+  CPU_INT08U stage;
+  CPU_INT08U b;
+  CPU_SR_ALLOC();
+  
+  if(!dumpReq)
+    return;
+  dumpReq = FALSE;
+  
+  sprintf(latLine,"\n LATENCY HIST, TS AT %lu HZ\n",
+                  (unsigned long) LatencyFreq());
+  PutMsg(latLine);
+  
+  for(stage=0;stage<NumLatStages;stage++)
+    for(b=0;b<IsrBuckets;b++)
+    {
+      //ServiceTx() may be adding to this bucket
+      CPU_CRITICAL_ENTER();
+      count = stages[stage].hist[b];
+      stages[stage].hist[b] = 0;
+      CPU_CRITICAL_EXIT();
+  
+      if(count == 0)
+        continue;
+      sprintf(latLine,"  %s < 2^%u: %lu\n",stageNames[stage],(unsigned) b,
+                      (unsigned long) count);
+      PutMsg(latLine);
+    }
+}
+
+/*--------------- L a t A d d ( ) ---------------*/
+
+/*
+PURPOSE
+Count one time into a stage. Called from ServiceTx().
+
+INPUT PARAMETERS
+stage - the stage
+t     - the time, LatNow() counts
+*/
+static void LatAdd(CPU_INT08U stage,CPU_TS t)
+{
+  LatStage *s = &stages[stage];
+  
+  IsrHistAdd(s->hist,t);
+  s->count++;
+  s->sum += t;
+  if(t > s->max)
+    s->max = t;
+}
@@ -0,0 +1,58 @@
+#ifndef __latency__
+#define __latency__
+/*--------------- L a t e n c y . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Latency.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// The stamp clock. By default the uC/CPU timestamp timer: the cycle
+// counter on the target, clock_gettime() nanoseconds on the host. A
+// build can plug in any free running 32 bit counter, a hardware timer
+// for instance, by defining both of these.
+#ifndef LatNow
+#define LatNow() CPU_TS_Get32()
+#define LatFreq(err) CPU_TS_TmrFreqGet(err)
+#endif
+
+// Pipeline stages, each from the stamp before it
+#define LatParse 0        // First preamble byte to frame closed
+#define LatRender 1       // Frame closed to message rendered
+#define LatTx 2           // Message rendered to its last byte sent
+#define LatTotal 3        // First preamble byte to last byte sent
+#define NumLatStages 4
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// When a packet passed each stage, in LatNow() counts. The stamps
+// travel with the packet, then with each message rendered from it.
+typedef struct
+{
+  CPU_TS rx;          // First preamble byte read by ServiceRx()
+  CPU_TS parsed;      // Frame closed by ParsePkt()
+  CPU_TS rendered;    // Message rendered by PayloadTask()
+} LatStamps;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void LatencyDone(LatStamps *stamps);
+void LatencyGet(CPU_INT08U stage,CPU_INT32U *count,
+                CPU_TS *avg,CPU_TS *max);
+CPU_INT32U LatencyFreq(void);
+const CPU_CHAR *LatencyName(CPU_INT08U stage);
+void LatencyRequestDump(void);
+void LatencyPoll(void);
+
+#endif
@@ -0,0 +1,192 @@
+/*--------------- L o g . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Deferred logging. LogPut() only stores a format string pointer and its
+integer arguments in a RAM ring; the formatting and the serial output
+are left to a task just above idle. A full ring drops the entry and
+counts it; the caller never blocks.
+
+The log task sleeps on its task semaphore until there is something to
+render. A writer posts it when the entry it has just completed is the
+next one the task will render: the ring was empty to the task, or the
+task stopped at this entry while it was still being written. Entries
+behind it are left to the pass that post starts, so a burst of entries
+costs one post.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Claim slots under IntMask()
+10-19-2026 dwt - Post the log task instead of polling the ring
+10-19-2026 dwt - Entry fields volatile, so the format pointer is stored last
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Log.h"
+#include "Intrpt.h"
+#include "assert.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define LOG_STK_SIZE 256              // Log task stack size
+#define LogPrio (OS_CFG_PRIO_MAX-2u)  // Log task Priority, just above idle
+
+#define LogLineSize 128
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// Every field is volatile, so neither side's compiler moves the other
+// fields' accesses past the format pointer that publishes the entry
+typedef struct
+{
+  const CPU_CHAR * volatile fmt;    // NULL until the entry is complete
+  volatile CPU_INT08U lane;         // TX lane for the rendered line
+  volatile CPU_INT32S args[LogMaxArgs];
+} LogEntry;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static  OS_TCB   logTCB;                       // Log task TCB
+static  CPU_STK  logStk[LOG_STK_SIZE];         // Space for Log task stack
+
+static LogEntry logRing[LogSize];
+static volatile CPU_INT16U logPut;     // Entries claimed, free running
+static volatile CPU_INT16U logGet;     // Entries rendered, free running
+static CPU_INT32U logDropped;          // Entries lost to a full ring
+
+static CPU_CHAR logLine[LogLineSize];
+
+/*--------------- L o g I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Empty the ring and create the log task.
+*/
+void LogInit(void)
+{
+  OS_ERR osErr;
+  
+  Mem_Clr(logRing,sizeof(logRing));
+  logPut = 0;
+  logGet = 0;
+  
+  //create log task
+  OSTaskCreate(&logTCB,                // Task Control Block
+               "Log Task",             // Task name
+               LogTask,                // Task entry point
+               NULL,                   // Address of optional task data block
+               LogPrio,                // Task priority
+               &logStk[0],             // Base address of task stack space
+               LOG_STK_SIZE / 10,      // Stack water mark limit
+               LOG_STK_SIZE,           // Task stack size
+               0,                      // This task has no task queue
+               0,                      // Number of clock ticks (defaults to 10)
+               NULL,                   // Pointer to TCB extension
+               (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   // Task options
+               &osErr);
+  assert(osErr==OS_ERR_NONE);
+}
+
+/*--------------- L o g P u t ( ) ---------------*/
+
+/*
+PURPOSE
+Record one log entry. Safe from tasks and from ISRs below IntMaskPrio:
+claiming the slot is the only step done masked, and the entry is
+published by storing the format pointer last. Wake the log task if the
+entry is the next one to render.
+
+INPUT PARAMETERS
+lane - TX lane for the rendered line
+fmt  - printf style format taking up to LogMaxArgs ints
+a0.. - the arguments
+*/
+void LogPut(CPU_INT08U lane,const CPU_CHAR *fmt,
+            CPU_INT32S a0,CPU_INT32S a1,CPU_INT32S a2,CPU_INT32S a3)
+{
+  LogEntry *entry;
+  CPU_INT16U slot;
+  CPU_INT32U basepri;
+  OS_ERR osErr;
+  
+  basepri = IntMask();
+  if((CPU_INT16U)(logPut - logGet) >= LogSize)
+  {
+    logDropped++;
+    IntUnmask(basepri);
+    return;
+  }
+  slot = logPut++;
+  entry = &logRing[slot & (LogSize-1)];
+  IntUnmask(basepri);
+  
+  entry->lane = lane;
+  entry->args[0] = a0;
+  entry->args[1] = a1;
+  entry->args[2] = a2;
+  entry->args[3] = a3;
+  entry->fmt = fmt;
+  
+  //the task renders up to the first incomplete entry, so only the
+  //writer of the entry at logGet need wake it
+  if(slot == logGet)
+    OSTaskSemPost(&logTCB,OS_OPT_POST_NONE,&osErr);
+}
+
+/*--------------- L o g T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Each time LogPut() posts, render the completed entries in order and
+send each on its lane. An entry still being written stops the pass;
+its writer posts again once it is complete.
+*/
+void LogTask(void *data)
+{
+  OS_ERR osErr;
+  LogEntry *entry;
+  CPU_INT08U lane;
+  
+  for(;;)
+  {
+    OSTaskSemPend(SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+    assert(osErr==OS_ERR_NONE);
+    
+    while(logGet != logPut)
+    {
+      entry = &logRing[logGet & (LogSize-1)];
+      if(entry->fmt == NULL)
+        break;
+      
+      sprintf(logLine,entry->fmt,
+              entry->args[0],entry->args[1],entry->args[2],entry->args[3]);
+      lane = entry->lane;
+      
+      //free the slot before the slow part
+      entry->fmt = NULL;
+      logGet++;
+      
+      PutLaneMsg(lane,logLine);
+    }
+  }
+}
+
+/*--------------- L o g D r o p p e d ( ) ---------------*/
+
+/*
+PURPOSE
+Report how many entries were lost to a full ring.
+
+RETURN VALUE
+The number of entries dropped since power up
+*/
+CPU_INT32U LogDropped(void)
+{
+  return logDropped;
+}
@@ -0,0 +1,46 @@
+#ifndef __log__
+#define __log__
+/*--------------- L o g . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Log.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Drop LogPollTicks, the log task is posted instead
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Integer arguments one entry can carry
+#define LogMaxArgs 4
+
+// Entries the ring holds; must be a power of 2
+#ifndef LogSize
+#define LogSize 32
+#endif
+
+// Log a const format string and up to LogMaxArgs integers. The string
+// must outlive the entry, so only string literals belong here.
+#define Log0(lane,fmt)           LogPut(lane,fmt,0,0,0,0)
+#define Log1(lane,fmt,a)         LogPut(lane,fmt,a,0,0,0)
+#define Log2(lane,fmt,a,b)       LogPut(lane,fmt,a,b,0,0)
+#define Log3(lane,fmt,a,b,c)     LogPut(lane,fmt,a,b,c,0)
+#define Log4(lane,fmt,a,b,c,d)   LogPut(lane,fmt,a,b,c,d)
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void LogInit(void);
+void LogTask(void *data);
+void LogPut(CPU_INT08U lane,const CPU_CHAR *fmt,
+            CPU_INT32S a0,CPU_INT32S a1,CPU_INT32S a2,CPU_INT32S a3);
+CPU_INT32U LogDropped(void);
+
+#endif
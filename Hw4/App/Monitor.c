@@ -0,0 +1,156 @@
+/*--------------- M o n i t o r . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Task monitor. Once a second, from the statistic task hook, sample every
+task's CPU usage, context switch count and stack high-water mark. The
+report task publishes the latest samples every MonitorSec seconds as
+one line per task, so stack sizes can be trimmed and CPU saturation
+seen before frames are lost.
+
+Needs OS_CFG_DBG_EN for the task list, OS_CFG_TASK_PROFILE_EN for the
+per-task counters and OS_CFG_STAT_TASK_EN for the hook. Stack use is
+only known for tasks created with OS_OPT_TASK_STK_CHK.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Report the longest IntMask() stretch
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Monitor.h"
+#include "Intrpt.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define MonLineSize 80
+
+// Per-task CPU usage is in hundredths of a percent from V3.03 on
+#if defined(OS_VERSION) && OS_VERSION >= 30300u
+#define UsageScale 100u
+#else
+#define UsageScale 1u
+#endif
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  OS_TCB *tcb;                  // Task sampled, NULL if slot unused
+  OS_PRIO prio;
+  OS_CPU_USAGE usage;           // CPU usage at the last sample
+  OS_CTX_SW_CTR ctxSw;          // Switches to the task, at the last sample
+  OS_CTX_SW_CTR ctxSwReported;  // ... and at the last report
+  CPU_STK_SIZE stkUsed;         // Stack high-water mark, 0 if unknown
+  CPU_STK_SIZE stkSize;         // Stack size in CPU_STK elements
+} TaskSample;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static TaskSample samples[MonMaxTasks];
+static CPU_INT08U sampleDiv = OS_CFG_STAT_TASK_RATE_HZ;  // Hook calls per sample
+static CPU_INT16U secsLeft = MonitorSec;                 // Until the next record
+static CPU_CHAR monLine[MonLineSize];
+
+/*--------------- M o n i t o r S a m p l e ( ) ---------------*/
+
+/*
+PURPOSE
+Called from App_OS_StatTaskHook(), OS_CFG_STAT_TASK_RATE_HZ times a
+second; samples every task once a second. Stack checking walks each
+stack from its far end, so it is kept out of the faster rate.
+*/
+void MonitorSample(void)
+{
+#if OS_CFG_DBG_EN > 0u && OS_CFG_TASK_PROFILE_EN > 0u
+  OS_ERR osErr;
+  OS_TCB *tcb;
+  TaskSample *sample;
+  CPU_STK_SIZE stkFree;
+  CPU_STK_SIZE stkUsed;
+  
+  if(--sampleDiv > 0)
+    return;
+  sampleDiv = OS_CFG_STAT_TASK_RATE_HZ;
+  
+  for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+  {
+    OSTaskStkChk(tcb,&stkFree,&stkUsed,&osErr);
+    if(osErr != OS_ERR_NONE)
+      stkUsed = 0;
+    
+    //the report task outranks this one; keep it out mid-update
+    OSSchedLock(&osErr);
+    
+    //find the task's slot, or claim a free one
+    for(sample = samples;sample < samples+MonMaxTasks;sample++)
+      if(sample->tcb == tcb || sample->tcb == NULL)
+        break;
+    
+    if(sample < samples+MonMaxTasks)
+    {
+      if(sample->tcb == NULL)
+      {
+        sample->tcb = tcb;
+        sample->ctxSwReported = tcb->CtxSwCtr;
+      }
+      sample->prio = tcb->Prio;
+      sample->usage = tcb->CPUUsage;
+      sample->ctxSw = tcb->CtxSwCtr;
+      sample->stkUsed = stkUsed;
+      sample->stkSize = tcb->StkSize;
+    }
+    
+    OSSchedUnlock(&osErr);
+  }
+#endif
+}
+
+/*--------------- M o n i t o r R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. Every MonitorSec seconds, send
+the total CPU usage, the longest stretch spent under IntMask() since the
+last record, and one line per task: priority, CPU usage, context
+switches since the last record, and stack used out of its size.
+*/
+void MonitorReport(void)
+{
+  OS_ERR osErr;
+  TaskSample snap;
+  TaskSample *sample;
+  
+  if(--secsLeft > 0)
+    return;
+  secsLeft = MonitorSec;
+  
+  sprintf(monLine,"\n MONITOR: CPU %u%%, MASKED MAX %lu TS\n",
+                  (unsigned) (OSStatTaskCPUUsage / UsageScale),
+                  (unsigned long) IntMaskMaxGet());
+  IntMaskMaxReset();
+  PutMsg(monLine);
+  
+  for(sample = samples;sample < samples+MonMaxTasks && sample->tcb != NULL;sample++)
+  {
+    OSSchedLock(&osErr);
+    snap = *sample;
+    sample->ctxSwReported = sample->ctxSw;
+    OSSchedUnlock(&osErr);
+    
+    sprintf(monLine,"   %-16.16s P%-2u CPU %3u%% SW %6lu STK %4lu/%lu\n",
+                    snap.tcb->NamePtr,
+                    (unsigned) snap.prio,
+                    (unsigned) (snap.usage / UsageScale),
+                    (unsigned long) (snap.ctxSw - snap.ctxSwReported),
+                    (unsigned long) snap.stkUsed,
+                    (unsigned long) snap.stkSize);
+    PutMsg(monLine);
+  }
+}
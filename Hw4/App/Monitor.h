@@ -0,0 +1,36 @@
+#ifndef __monitor__
+#define __monitor__
+/*--------------- M o n i t o r . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Monitor.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Tasks the monitor can follow
+#ifndef MonMaxTasks
+#define MonMaxTasks 12
+#endif
+
+// Seconds between task monitor records
+#ifndef MonitorSec
+#define MonitorSec 10
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void MonitorSample(void);
+void MonitorReport(void);
+
+#endif
@@ -0,0 +1,277 @@
+/*--------------- N o d e T a b l e . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Remember the last value sent for every source node and message type,
+and decide whether a new reading is worth transmitting. A reading is
+sent when any field moves by more than the deadband for its type, when
+the node's heartbeat interval has expired, or the first time it is seen.
+Everything else is counted as suppressed.
+
+Also hands out compact node slots for the per-node tables (Stats,
+History) that are too big to index directly by srcAddr.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Load a deadband per type, take deltas without overflow
+10-19-2026 dwt - Slots are claimed once per reading
+*/
+
+#include "includes.h"
+#include "Payload.h"
+#include "NodeTable.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define NumAddrs 256
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// Last value sent for one node and message type. Fields are kept in
+// 16 bits; every tracked field fits, and deltas are taken modulo 2^16.
+typedef struct
+{
+  CPU_INT16U value[MaxFields];
+  OS_TICK lastSent;
+} NodeEntry;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static NodeEntry nodeTable[NodeTableSize][NumTracked];
+static CPU_INT08U nodeSeen[NodeTableSize];     // Bit per tracked type seen
+static CPU_INT16U deadband[NumTracked];
+static CPU_INT32U suppressed[NumTracked];
+static OS_TICK heartbeat;
+
+// Default deadband of each tracked type, TempMsg through PrecipMsg
+static const CPU_INT16U defaultDeadband[NumTracked] =
+{
+  TempDeadband,
+  BaroDeadband,
+  HumDeadband,
+  WindDeadband,
+  RadDeadband,
+  0,                // TimeMsg, never compared
+  PrecipDeadband
+};
+
+static CPU_INT08U slotOf[NumAddrs];       // srcAddr -> slot, NoSlot if none
+static CPU_INT08U addrOf[NodeSlots];      // slot -> srcAddr
+static CPU_INT08U numSlots;
+static CPU_INT32U slotsFull;              // Slot requests with none left
+
+/*--------------- N o d e T a b l e I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Forget every node, zero the suppressed counts and load the default
+deadband of each type and the heartbeat setting.
+*/
+void NodeTableInit(void)
+{
+  CPU_INT08U type;
+  
+  Mem_Clr(nodeSeen,sizeof(nodeSeen));
+  Mem_Clr(suppressed,sizeof(suppressed));
+  Mem_Set(slotOf,NoSlot,sizeof(slotOf));
+  numSlots = 0;
+  slotsFull = 0;
+  
+  for(type=0;type<NumTracked;type++)
+    NodeTableSetDeadband(type+TempMsg,defaultDeadband[type]);
+  
+  NodeTableSetHeartbeat(HeartbeatSec);
+}
+
+/*--------------- N o d e T a b l e U p d a t e ( ) ---------------*/
+
+/*
+PURPOSE
+Compare a reading against the last value sent by the same node.
+
+INPUT PARAMETERS
+reading - the decoded reading
+
+RETURN VALUE
+TRUE if the reading should be sent, FALSE if it was suppressed.
+Readings with no numeric fields are always sent.
+*/
+CPU_BOOLEAN NodeTableUpdate(Reading *reading)
+{
+  NodeEntry *entry;
+  CPU_INT16U delta;
+  CPU_INT08U i;
+  CPU_INT08U type = reading->msgType - TempMsg;
+  CPU_BOOLEAN send;
+  OS_TICK now;
+  OS_ERR osErr;
+  
+  //time stamps change every minute and don't fit the 16 bit slots
+  if(reading->numFields == 0 || reading->msgType == TimeMsg ||
+     type >= NumTracked || reading->srcAddr >= NodeTableSize)
+    return TRUE;
+  
+  entry = &nodeTable[reading->srcAddr][type];
+  now = OSTimeGet(&osErr);
+  
+  //first reading from this node, or heartbeat expired
+  send = !(nodeSeen[reading->srcAddr] & (1<<type)) ||
+         (heartbeat && now - entry->lastSent >= heartbeat);
+  
+  //otherwise any field outside the deadband
+  for(i=0;i<reading->numFields && !send;i++)
+  {
+    //magnitude of the change modulo 2^16, 0x8000 at most
+    delta = (CPU_INT16U)((CPU_INT16U)reading->field[i] - entry->value[i]);
+    if(delta & 0x8000)
+      delta = (CPU_INT16U)-delta;
+    if(delta > deadband[type])
+      send = TRUE;
+  }
+  
+  if(!send)
+  {
+    suppressed[type]++;
+    return FALSE;
+  }
+  
+  //remember what was sent
+  for(i=0;i<reading->numFields;i++)
+    entry->value[i] = (CPU_INT16U)reading->field[i];
+  entry->lastSent = now;
+  nodeSeen[reading->srcAddr] |= 1<<type;
+  
+  return TRUE;
+}
+
+/*--------------- N o d e T a b l e S e t D e a d b a n d ( ) ---------------*/
+
+/*
+PURPOSE
+Set how far a field must move before a reading of this type is sent.
+
+INPUT PARAMETERS
+msgType - the message type
+band    - deadband in the decoded field's units (0 = send any change)
+*/
+void NodeTableSetDeadband(CPU_INT08U msgType,CPU_INT16U band)
+{
+  CPU_INT08U type = msgType - TempMsg;
+  
+  if(type < NumTracked)
+    deadband[type] = band;
+}
+
+/*--------------- N o d e T a b l e S e t H e a r t b e a t ( ) ---------------*/
+
+/*
+PURPOSE
+Set the interval after which an unchanged reading is sent anyway.
+
+INPUT PARAMETERS
+seconds - heartbeat interval (0 = never)
+*/
+void NodeTableSetHeartbeat(CPU_INT16U seconds)
+{
+  heartbeat = (OS_TICK)seconds * OSCfg_TickRate_Hz;
+}
+
+/*--------------- N o d e T a b l e S u p p r e s s e d ( ) ---------------*/
+
+/*
+PURPOSE
+Report how many readings of a type have been suppressed.
+
+INPUT PARAMETERS
+msgType - the message type
+
+RETURN VALUE
+The suppressed count since NodeTableInit()
+*/
+CPU_INT32U NodeTableSuppressed(CPU_INT08U msgType)
+{
+  CPU_INT08U type = msgType - TempMsg;
+  
+  if(type >= NumTracked)
+    return 0;
+  
+  return suppressed[type];
+}
+
+/*--------------- N o d e S l o t ( ) ---------------*/
+
+/*
+PURPOSE
+Find a node's slot, claiming the next free one the first time the
+node is heard. PayloadTask calls this once per reading, so a reading
+that finds every slot taken is counted once.
+
+INPUT PARAMETERS
+srcAddr - the node address
+
+RETURN VALUE
+The slot number, or NoSlot if every slot is taken.
+*/
+CPU_INT08U NodeSlot(CPU_INT08U srcAddr)
+{
+  CPU_INT08U slot = slotOf[srcAddr];
+  
+  if(slot != NoSlot)
+    return slot;
+  
+  if(numSlots >= NodeSlots)
+  {
+    slotsFull++;
+    return NoSlot;
+  }
+  
+  slot = numSlots++;
+  addrOf[slot] = srcAddr;
+  slotOf[srcAddr] = slot;
+  
+  return slot;
+}
+
+/*--------------- F i n d N o d e S l o t ( ) ---------------*/
+
+/*
+PURPOSE
+Find a node's slot without claiming one.
+
+RETURN VALUE
+The slot number, or NoSlot if the node has none.
+*/
+CPU_INT08U FindNodeSlot(CPU_INT08U srcAddr)
+{
+  return slotOf[srcAddr];
+}
+
+/*--------------- S l o t A d d r ( ) ---------------*/
+
+CPU_INT08U SlotAddr(CPU_INT08U slot)
+{
+  return addrOf[slot];
+}
+
+/*--------------- N u m N o d e S l o t s ( ) ---------------*/
+
+CPU_INT08U NumNodeSlots(void)
+{
+  return numSlots;
+}
+
+/*--------------- N o d e S l o t s F u l l ( ) ---------------*/
+
+/*
+PURPOSE
+Report how many readings found every node slot taken.
+*/
+CPU_INT32U NodeSlotsFull(void)
+{
+  return slotsFull;
+}
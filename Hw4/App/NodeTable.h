@@ -0,0 +1,77 @@
+#ifndef __nodetable__
+#define __nodetable__
+/*--------------- N o d e T a b l e . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "NodeTable.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Deadband defaults per message type
+*/
+#include "includes.h"
+#include "Payload.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// One slot per source address, indexed directly by srcAddr
+#ifndef NodeTableSize
+#define NodeTableSize 256
+#endif
+
+// Re-send an unchanged reading at least this often (seconds, 0 = never)
+#ifndef HeartbeatSec
+#define HeartbeatSec 60
+#endif
+
+// Change a field must exceed before a reading is sent again, per
+// message type, in the decoded field's units (0 = send any change)
+#ifndef TempDeadband
+#define TempDeadband 1        // Degrees
+#endif
+#ifndef BaroDeadband
+#define BaroDeadband 1        // Pressure units
+#endif
+#ifndef HumDeadband
+#define HumDeadband 1         // Dew point degrees and percent humidity
+#endif
+#ifndef WindDeadband
+#define WindDeadband 5        // Tenths of speed units and degrees
+#endif
+#ifndef RadDeadband
+#define RadDeadband 5         // Radiation units
+#endif
+#ifndef PrecipDeadband
+#define PrecipDeadband 0      // Hundredths; every change of the total
+#endif
+
+// Compact slots handed out to the first nodes heard, for tables too
+// big to index directly by srcAddr
+#ifndef NodeSlots
+#define NodeSlots 16
+#endif
+#define NoSlot 0xFF
+
+// Message types with a tracked value: TempMsg through PrecipMsg
+#define NumTracked (PrecipMsg-TempMsg+1)
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void NodeTableInit(void);
+CPU_BOOLEAN NodeTableUpdate(Reading *reading);
+void NodeTableSetDeadband(CPU_INT08U msgType,CPU_INT16U band);
+void NodeTableSetHeartbeat(CPU_INT16U seconds);
+CPU_INT32U NodeTableSuppressed(CPU_INT08U msgType);
+CPU_INT08U NodeSlot(CPU_INT08U srcAddr);
+CPU_INT08U FindNodeSlot(CPU_INT08U srcAddr);
+CPU_INT08U SlotAddr(CPU_INT08U slot);
+CPU_INT08U NumNodeSlots(void);
+CPU_INT32U NodeSlotsFull(void);
+
+#endif
@@ -11,13 +11,38 @@ Handles the processing of packets
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Decode readings, suppress unchanged ones via NodeTable
+10-19-2026 dwt - Feed Stats, add summary-only output mode
+10-19-2026 dwt - Record History, answer history queries
+10-19-2026 dwt - Check alert rules, send alerts ahead of the reading
+10-19-2026 dwt - Decode DATE/TIME to epoch seconds, set the wall clock
+10-19-2026 dwt - Drain every ready buffer per wakeup into one TX burst
+10-19-2026 dwt - Send errors and alerts on the high priority lane
+10-19-2026 dwt - Queue telemetry through TxQueue under an overload policy
+10-19-2026 dwt - Count unknown message types as errors
+10-19-2026 dwt - Errors are logged, not rendered here
+10-19-2026 dwt - Run diagnostic commands
+10-19-2026 dwt - Buffer handoff through Signals
+10-19-2026 dwt - Clear windSpeed before unrolling the BCD speed into it
+10-19-2026 dwt - Pass each packet's latency stamps on with its messages
+10-19-2026 dwt - A good frame of type 0 is an unknown type error
+10-19-2026 dwt - Start in the OutputMode build default
+10-19-2026 dwt - Claim a reading's node slot once for Stats and History
 */
 
 #include "includes.h"
 #include "SerIODriver.h"
 #include "BfrPair.h"
 #include "Payload.h"
+#include "NodeTable.h"
+#include "Stats.h"
+#include "History.h"
+#include "Alert.h"
+#include "Calendar.h"
+#include "TxQueue.h"
+#include "Command.h"
 #include "Error.h"
+#include "PktParser.h"
 #include "assert.h"
 
 // -----c o n s t a n t    d e f i n i t i o n s -----
@@ -26,16 +51,87 @@ CHANGES
 #define PAYLOAD_STK_SIZE 512  // Producer task Priority
 #define PayloadPrio 4          // Producer task Priority
 
+// Largest rendering of one payload: alerts plus a history reply frame
+#define MaxRenderSize (AlertBfrSize + 256)
+
 //----- g l o b a l    v a r i a b l e s -----
 
-static  OS_TCB   payloadTCB;                     // Producer task TCB 
+        OS_TCB   payloadTCB;                     // Producer task TCB 
 static  CPU_STK  PayloadStk[PAYLOAD_STK_SIZE];  // Space for Producer task stack
 
+// The payload buffer pair, shared with the parser
+BfrPair payloadBfrPair;
+static CPU_INT08U pBfr0Space[sizeof(Payload)];
+static CPU_INT08U pBfr1Space[sizeof(Payload)];
+
+//Signals
+Signal openPayloadBfrs;
+Signal closedPayloadBfrs;
+
+// Output for one lane collected during a wakeup
+typedef struct
+{
+  CPU_INT08U data[BurstSize];       // Messages back to back
+  CPU_INT16U len;                   // Bytes used
+  CPU_INT16U msgLen[BurstMsgs];     // Length of each message
+  LatStamps stamps[BurstMsgs];      // Stamps of the packet it came from
+  CPU_INT08U numMsgs;               // Messages held
+} Burst;
+
+static Burst bursts[NumTxLanes];        // Output for one wakeup
+static CPU_INT32U wakeups;              // Times PayloadTask woke
+static CPU_INT32U frames;               // Payloads processed
+
+static CPU_INT08U outputMode = OutputMode;
+
+// First metric of each message type, NoMetric if it has none
+static const CPU_INT08U firstMetric[IDMsg+1] =
+{
+  NoMetric,     // ErrMsg
+  TempMetric,   // TempMsg
+  BaroMetric,   // BaroMsg
+  DewPtMetric,  // HumMsg: dew point, humidity
+  SpeedMetric,  // WindMsg: speed, direction
+  RadMetric,    // RadMsg
+  NoMetric,     // TimeMsg
+  PrecipMetric, // PrecipMsg
+  NoMetric      // IDMsg
+};
+
+static const CPU_CHAR *metricNames[NumMetrics] =
+{
+  "Temperature",
+  "Pressure",
+  "Dew Point",
+  "Humidity",
+  "Wind Speed x10",
+  "Wind Direction",
+  "Solar Radiation",
+  "Precipitation x100"
+};
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void ProcessPayload(Payload *payload);
+static CPU_CHAR *BurstEnd(CPU_INT08U lane);
+static void BurstAdd(CPU_INT08U lane,CPU_INT16U len,LatStamps *stamps);
+static CPU_BOOLEAN BurstsFull(void);
+static void FlushBursts(void);
+
+/*--------------- P a y l o a d I n i t ( ) ---------------*/
+
 void PayloadInit(void)
 {
   OS_ERR osErr;
   // Create and initialize payload buffer pair.
-  BfrPairInit(&payloadBfrPair,pBfr0Space,pBfr1Space,PayloadBfrSize);
+  BfrPairInit(&payloadBfrPair,pBfr0Space,pBfr1Space,sizeof(Payload));
+  
+  // Clear the per-node last-value table and history.
+  CalInit();
+  NodeTableInit();
+  HistoryInit();
+  AlertInit();
+  TxQueueInit();
   
   //create payload task
   OSTaskCreate(&payloadTCB,            // Task Control Block                 
@@ -55,112 +151,425 @@ void PayloadInit(void)
   /* Verify successful task creation. */
   assert(osErr == OS_ERR_NONE);
   
-  //Create semaphore openPayloadBfrs=2
-  OSSemCreate(&openPayloadBfrs,"Open payloadBfrs",2,&osErr);
-  assert(osErr==OS_ERR_NONE);
+  //Create signal openPayloadBfrs=2, pended on by the parser
+  SignalCreate(&openPayloadBfrs,"Open payloadBfrs",2,&parseTCB);
 
-  //Create semaphore closedPayloadBfrs=0
-  OSSemCreate(&closedPayloadBfrs,"Closed payloadBfrs",0,&osErr);
-  assert(osErr==OS_ERR_NONE);  
+  //Create signal closedPayloadBfrs=0, pended on by this task
+  SignalCreate(&closedPayloadBfrs,"Closed payloadBfrs",0,&payloadTCB);
 }
+/*--------------- P a y l o a d T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Wait for closed payload buffers and turn them into output. With
+PayloadBatch set, every buffer that is ready on a wakeup is rendered
+into one burst per output lane. Alerts go to TX in a single
+PutLaneBurst() on the high priority lane, ahead of any telemetry still
+queued. Telemetry goes to TxQueue, which never blocks, so a slow link
+cannot hold up the parser.
+*/
 void PayloadTask(void *data)
 {
-  CPU_INT08U* msgBfr;
-  CPU_CHAR id[IdSize+1];
-  Payload *payload;
   OS_ERR osErr;
   
   for(;;)
   {
-    //if buffer empty, we wait till it can be swapped
-    if(!GetBfrClosed(&payloadBfrPair))
+    //wait for the parser to close a payload buffer
+    SignalPend(&closedPayloadBfrs);
+    wakeups++;
+    
+    do
     {
-      OSSemPend(&closedPayloadBfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
-      assert(osErr==OS_ERR_NONE);
-      
+      //the parser swaps this pair too; keep it out between test and swap
+      OSSchedLock(&osErr);
       if(BfrPairSwappable(&payloadBfrPair))
         BfrPairSwap(&payloadBfrPair);
-    }
-    //if still not closed, return
-    if(!GetBfrClosed(&payloadBfrPair))
-      return;
-    
-    payload = (Payload *) GetBfrAddr(&payloadBfrPair);
-    
-    //check for errors
-    if(payload->payloadLen<0)
-      payload->msgType = ErrMsg;
+      OSSchedUnlock(&osErr);
       
-    switch(payload->msgType)
-    {
-    case ErrMsg:
-      HandleErr(msgBfr,payload->payloadLen);
-      break;
-    case TempMsg: //Temperature Message
-      sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: TEMPERATURE MESSAGE\n"
-                                   "   Temperature = %d\n",
-                                       payload->srcAddr,
-                                       payload->dataPart.temp);
-      break;
-    case BaroMsg: //Barometric Pressure msg
-      //swap bytes to fix endianness
-      payload->dataPart.pres = (payload->dataPart.pres<<ByteSize) | 
-                           (payload->dataPart.pres>>ByteSize);
+      if(!GetBfrClosed(&payloadBfrPair))
+        break;
+      
+      //leave room for the largest rendering
+      if(BurstsFull())
+        FlushBursts();
+      
+      ProcessPayload((Payload *) GetBfrAddr(&payloadBfrPair));
+      frames++;
+      OpenGetBfr(&payloadBfrPair);
       
-      sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: BAROMETRIC PRESSURE MESSAGE\n"
-                                   "   Pressure = %u\n", payload->srcAddr,
-                                                         payload->dataPart.pres);
-      break;
-    case HumMsg: //Humidity msg
-      sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: HUMIDITY MESSAGE\n   "
-                                   "Dew Point = %d Humidity = %d\n", 
-                                    payload->srcAddr,
-                                    payload->dataPart.hum.dewPt,
-                                    payload->dataPart.hum.hum);
-      break;
-    case WindMsg: //Wind msg
-      DisplayWind(msgBfr,payload->srcAddr,payload->dataPart.wind.speed,payload->dataPart.wind.dir);
-      break;
-    case RadMsg: //Radiation msg
-      //swap bytes to fix endianness
-      payload->dataPart.rad = (payload->dataPart.rad<<ByteSize) | 
-                          (payload->dataPart.rad>>ByteSize);
-      sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: SOLAR RADIATION MESSAGE\n"
-                                   "   Solar Radiation Intensity = %u\n", 
-                                       payload->srcAddr,
-                                       payload->dataPart.rad);
-      break;
-    case TimeMsg: //Date/Time msg 
-      DisplayDate(msgBfr,payload->srcAddr,payload->dataPart.dateTime);
-      break;
-    case PrecipMsg: //Precip msg
-      DisplayPrecip(msgBfr,payload->srcAddr,payload->dataPart.depth);
-      break;
-    case IDMsg: //ID msg
-      //copy message into a string 1 char longer
-      Str_Copy_N(id,(CPU_CHAR *)payload->dataPart.id,payload->payloadLen-HeaderLength);
-      //null terminate string at last char
-      id[payload->payloadLen-HeaderLength]='\0';
+      //Since buffer is now open, post
+      SignalPost(&openPayloadBfrs,
+                 PayloadBatch ? OS_OPT_POST_NO_SCHED : OS_OPT_POST_NONE);
       
-      sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: SENSOR ID MESSAGE\n"
-                                   "   Node ID = %s\n", 
-                                       payload->srcAddr,
-                                       id);
-      break;
-    default: //unknown msg type
-      break;
-    }
+      if(!PayloadBatch)
+        break;
+      
+      //take the next closed buffer as well, if there is one
+    } while(SignalAccept(&closedPayloadBfrs));
     
-    //PutReplyMsg(&replyBfrPair, msgBfr);
-    while(*msgBfr != '\0')
-      PutByte(*msgBfr++);
-    OpenGetBfr(&payloadBfrPair);
+    FlushBursts();
     
-    //Since buffer is now open, post
-    OSSemPost(&openPayloadBfrs,OS_OPT_POST_1,&osErr);
-    assert(osErr==OS_ERR_NONE);
+    //let the parser back in
+    if(PayloadBatch)
+      OSSched();
   }
 }
+
+/*--------------- P r o c e s s P a y l o a d ( ) ---------------*/
+
+/*
+PURPOSE
+Decode one payload, run it through the alert, statistics, history and
+deadband stages, and render whatever should be sent: alert lines into
+the high lane's burst, everything else into the bulk one. Errors are
+handed to HandleErr(), which logs them.
+
+INPUT PARAMETERS
+payload - the closed payload buffer
+*/
+static void ProcessPayload(Payload *payload)
+{
+  CPU_INT08U *msgBfr;
+  CPU_CHAR *alertBfr;
+  CPU_CHAR id[IdSize+1];
+  Reading reading;
+  LatStamps stamps = payload->stamps;
+  
+  //check for errors
+  if(payload->payloadLen<0)
+    payload->msgType = ErrMsg;
+  else if(payload->msgType == ErrMsg || payload->msgType > CmdMsg ||
+          payload->msgType == HistoryMsg)
+  {
+    //nothing a node sends, count it as an error
+    payload->payloadLen = UnknownErr;
+    payload->msgType = ErrMsg;
+  }
+  
+  //decode, check alerts, accumulate, then drop readings that haven't
+  //moved past their deadband or aren't wanted in summary-only mode
+  DecodeReading(payload,&reading);
+  if(reading.msgType == TimeMsg && reading.field[0] != 0)
+    CalSetClock(reading.field[0]);
+  alertBfr = BurstEnd(TxHigh);
+  AlertCheck(&reading,alertBfr);
+  BurstAdd(TxHigh,Str_Len(alertBfr),&stamps);
+  if(reading.numFields > 0)
+    NodeSlot(reading.srcAddr);    //once, so a full table counts it once
+  StatsUpdate(&reading);
+  HistoryAdd(&reading);
+  if(outputMode == OutputSummary && reading.numFields > 0)
+    payload->msgType = NoMsg;
+  else if(reading.numFields > 0 && TxQueueSummaryOnly())
+    payload->msgType = NoMsg;
+  else if(!NodeTableUpdate(&reading))
+    payload->msgType = NoMsg;
+  
+  msgBfr = (CPU_INT08U *) BurstEnd(TxBulk);
+  *msgBfr = '\0';
+  
+  switch(payload->msgType)
+  {
+  case ErrMsg:
+    HandleErr(payload->payloadLen);
+    return;
+  case TempMsg: //Temperature Message
+    sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: TEMPERATURE MESSAGE\n"
+                                 "   Temperature = %d\n",
+                                     payload->srcAddr,
+                                     payload->dataPart.temp);
+    break;
+  case BaroMsg: //Barometric Pressure msg
+    //swap bytes to fix endianness
+    payload->dataPart.pres = (payload->dataPart.pres<<ByteSize) | 
+                         (payload->dataPart.pres>>ByteSize);
+    
+    sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: BAROMETRIC PRESSURE MESSAGE\n"
+                                 "   Pressure = %u\n", payload->srcAddr,
+                                                       payload->dataPart.pres);
+    break;
+  case HumMsg: //Humidity msg
+    sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: HUMIDITY MESSAGE\n   "
+                                 "Dew Point = %d Humidity = %d\n", 
+                                  payload->srcAddr,
+                                  payload->dataPart.hum.dewPt,
+                                  payload->dataPart.hum.hum);
+    break;
+  case WindMsg: //Wind msg
+    DisplayWind(msgBfr,payload->srcAddr,payload->dataPart.wind.speed,payload->dataPart.wind.dir);
+    break;
+  case RadMsg: //Radiation msg
+    //swap bytes to fix endianness
+    payload->dataPart.rad = (payload->dataPart.rad<<ByteSize) | 
+                        (payload->dataPart.rad>>ByteSize);
+    sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: SOLAR RADIATION MESSAGE\n"
+                                 "   Solar Radiation Intensity = %u\n", 
+                                     payload->srcAddr,
+                                     payload->dataPart.rad);
+    break;
+  case TimeMsg: //Date/Time msg 
+    DisplayDate(msgBfr,payload->srcAddr,payload->dataPart.dateTime);
+    break;
+  case PrecipMsg: //Precip msg
+    DisplayPrecip(msgBfr,payload->srcAddr,payload->dataPart.depth);
+    break;
+  case IDMsg: //ID msg
+    //copy message into a string 1 char longer
+    Str_Copy_N(id,(CPU_CHAR *)payload->dataPart.id,payload->payloadLen-HeaderLength);
+    //null terminate string at last char
+    id[payload->payloadLen-HeaderLength]='\0';
+    
+    sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: SENSOR ID MESSAGE\n"
+                                 "   Node ID = %s\n", 
+                                     payload->srcAddr,
+                                     id);
+    break;
+  case QueryMsg: //History query: reply in binary
+    BurstAdd(TxBulk,HistoryReply(msgBfr,
+                                 payload->srcAddr,
+                                 payload->dataPart.query.node,
+                                 payload->dataPart.query.metric,
+                                 payload->dataPart.query.count),
+             &stamps);
+    return;
+  case CmdMsg: //Diagnostic command
+    RunCommand(payload->dataPart.cmd.code,payload->dataPart.cmd.arg);
+    break;
+  case NoMsg: //suppressed msg
+  default: //unknown msg type
+    break;
+  }
+  
+  BurstAdd(TxBulk,Str_Len((CPU_CHAR *) msgBfr),&stamps);
+}
+
+/*--------------- B u r s t E n d ( ) ---------------*/
+
+/*
+PURPOSE
+Find where the next message for a lane is to be rendered. The space is
+cleared to an empty string.
+
+INPUT PARAMETERS
+lane - TxHigh or TxBulk
+
+RETURN VALUE
+The first free byte of the lane's burst.
+*/
+static CPU_CHAR *BurstEnd(CPU_INT08U lane)
+{
+  Burst *burst = &bursts[lane];
+  
+  burst->data[burst->len] = '\0';
+  
+  return (CPU_CHAR *) &burst->data[burst->len];
+}
+
+/*--------------- B u r s t A d d ( ) ---------------*/
+
+/*
+PURPOSE
+Keep a message just rendered at BurstEnd(); an empty one is ignored.
+The message takes its packet's stamps, with the render time added.
+
+INPUT PARAMETERS
+lane   - TxHigh or TxBulk
+len    - the message length in bytes
+stamps - the stamps of the packet it was rendered from
+*/
+static void BurstAdd(CPU_INT08U lane,CPU_INT16U len,LatStamps *stamps)
+{
+  Burst *burst = &bursts[lane];
+  
+  if(len==0)
+    return;
+  
+  burst->stamps[burst->numMsgs] = *stamps;
+  burst->stamps[burst->numMsgs].rendered = LatNow();
+  burst->msgLen[burst->numMsgs++] = len;
+  burst->len += len;
+}
+
+/*--------------- B u r s t s F u l l ( ) ---------------*/
+
+/*
+PURPOSE
+Test whether either lane's burst might not hold one more rendering.
+
+RETURN VALUE
+TRUE if the bursts should be flushed first, otherwise FALSE
+*/
+static CPU_BOOLEAN BurstsFull(void)
+{
+  Burst *burst;
+  
+  for(burst = bursts;burst < bursts+NumTxLanes;burst++)
+    if(burst->len > BurstSize - MaxRenderSize ||
+       burst->numMsgs > BurstMsgs - 2)
+      return TRUE;
+  
+  return FALSE;
+}
+
+/*--------------- F l u s h B u r s t s ( ) ---------------*/
+
+/*
+PURPOSE
+Hand the high lane's burst straight to TX and queue each bulk message
+on TxQueue, then empty both bursts.
+*/
+static void FlushBursts(void)
+{
+  Burst *burst = &bursts[TxHigh];
+  CPU_INT08U *msg;
+  CPU_INT08U i;
+  
+  if(burst->numMsgs > 0)
+    PutLaneBurst(TxHigh,burst->data,burst->msgLen,burst->numMsgs,
+                 burst->stamps);
+  burst->len = 0;
+  burst->numMsgs = 0;
+  
+  burst = &bursts[TxBulk];
+  msg = burst->data;
+  for(i = 0;i < burst->numMsgs;i++)
+  {
+    TxQueuePut(msg,burst->msgLen[i],&burst->stamps[i]);
+    msg += burst->msgLen[i];
+  }
+  burst->len = 0;
+  burst->numMsgs = 0;
+}
+
+/*----- D e c o d e R e a d i n g ( ) -----*/
+
+/*
+PURPOSE
+Convert a packet into a Reading: byte-swap the big endian fields and
+unpack the BCD fields so later stages can compare plain integers.
+The payload itself is left untouched.
+
+INPUT PARAMETERS
+payload - the closed payload buffer
+reading - filled in with the decoded fields
+*/
+void DecodeReading(Payload *payload,Reading *reading)
+{
+  CPU_INT16U word;
+  CalDate date;
+  
+  reading->srcAddr = payload->srcAddr;
+  reading->msgType = payload->msgType;
+  reading->numFields = 1;
+  
+  switch(payload->msgType)
+  {
+  case TempMsg:
+    reading->field[0] = payload->dataPart.temp;
+    break;
+  case BaroMsg:
+    word = payload->dataPart.pres;
+    reading->field[0] = (CPU_INT16U)((word<<ByteSize) | (word>>ByteSize));
+    break;
+  case HumMsg:
+    reading->field[0] = payload->dataPart.hum.dewPt;
+    reading->field[1] = payload->dataPart.hum.hum;
+    reading->numFields = 2;
+    break;
+  case WindMsg:
+    word = payload->dataPart.wind.dir;
+    reading->field[0] = BcdToBin(payload->dataPart.wind.speed[0])*100 +
+                        BcdToBin(payload->dataPart.wind.speed[1]);
+    reading->field[1] = (CPU_INT16U)((word<<ByteSize) | (word>>ByteSize));
+    reading->numFields = 2;
+    break;
+  case RadMsg:
+    word = payload->dataPart.rad;
+    reading->field[0] = (CPU_INT16U)((word<<ByteSize) | (word>>ByteSize));
+    break;
+  case TimeMsg: //seconds since the epoch, 0 if the stamp is invalid
+    CalUnpack(CalFromWire(payload->dataPart.dateTime),&date);
+    reading->field[0] = (CPU_INT32S)CalToEpoch(&date);
+    break;
+  case PrecipMsg:
+    reading->field[0] = BcdToBin(payload->dataPart.depth[0])*100 +
+                        BcdToBin(payload->dataPart.depth[1]);
+    break;
+  default: //errors, IDs and unknown types carry no value
+    reading->numFields = 0;
+    break;
+  }
+}
+
+/*----- P a y l o a d W a k e u p s ( ) -----*/
+
+/*
+PURPOSE
+Report how many times PayloadTask has woken; with PayloadFrames() this
+gives the payloads handled per wakeup.
+*/
+CPU_INT32U PayloadWakeups(void)
+{
+  return wakeups;
+}
+
+/*----- P a y l o a d F r a m e s ( ) -----*/
+
+CPU_INT32U PayloadFrames(void)
+{
+  return frames;
+}
+
+/*----- M e t r i c O f ( ) -----*/
+
+/*
+PURPOSE
+Map a reading field to its metric number.
+
+INPUT PARAMETERS
+msgType - the message type
+field   - index into Reading.field
+
+RETURN VALUE
+The metric number, or NoMetric if the field isn't a metric.
+*/
+CPU_INT08U MetricOf(CPU_INT08U msgType,CPU_INT08U field)
+{
+  if(msgType > IDMsg || firstMetric[msgType] == NoMetric)
+    return NoMetric;
+  
+  return firstMetric[msgType] + field;
+}
+
+/*----- M e t r i c N a m e ( ) -----*/
+
+const CPU_CHAR *MetricName(CPU_INT08U metric)
+{
+  if(metric >= NumMetrics)
+    return "?";
+  
+  return metricNames[metric];
+}
+
+/*----- S e t O u t p u t M o d e ( ) -----*/
+
+/*
+PURPOSE
+Select between sending every reading (OutputAll) and sending only
+errors and periodic summaries (OutputSummary).
+*/
+void SetOutputMode(CPU_INT08U mode)
+{
+  outputMode = mode;
+}
+
+/*----- G e t O u t p u t M o d e ( ) -----*/
+
+CPU_INT08U GetOutputMode(void)
+{
+  return outputMode;
+}
+
 /*----- D i s p l a y P r e c i p ( ) -----*/
 
 void DisplayPrecip(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *depth)
@@ -192,7 +601,7 @@ void DisplayPrecip(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *depth)
 void DisplayWind(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *speed,CPU_INT16U dir)
 {
   CPU_INT08U i;
-  CPU_INT32U windSpeed;
+  CPU_INT32U windSpeed = 0;
   
   //swap bytes for endianness
   dir = (dir<<ByteSize) |
@@ -226,25 +635,19 @@ void DisplayWind(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *speed,CPU_INT16U
 
 void DisplayDate(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT32U date)
 {
-  CPU_INT16U mask = ~0; //Make 0xFFFF
+  CalDate cal;
   
-  // swap bytes for endianness
-  // swap ends then middle two
-  date = ((date<<EndBytePosition)&(CPU_INT32U)(ByteMask<<EndBytePosition)) | 
-         ((date>>EndBytePosition)&ByteMask) |
-         ((date>>MiddleBytePosition)&(ByteMask<<MiddleBytePosition)) |
-         ((date<<MiddleBytePosition)&(ByteMask<<(EndBytePosition-MiddleBytePosition)));
+  // swap bytes for endianness and split out the fields
+  CalUnpack(CalFromWire(date),&cal);
   
-  // mask out date parts: shift by position then 
-  // generate a bitmask based on length of field 
   sprintf((CPU_CHAR *) msgBfr, "\n SOURCE NODE %d: DATE/TIME STAMP MESSAGE\n"
                                "   Time Stamp = %u/%u/%u %u:%u \n", 
                                    addr,
-    date>>(MonthPosition)&(mask>>(sizeof(mask)*ByteSize-MonthLength)),
-    date>>(DayPosition)&(mask>>(sizeof(mask)*ByteSize-DayLength)),
-    date>>(YearPosition)&(mask>>(sizeof(mask)*ByteSize-YearLength)),
-    date>>(HourPosition)&(mask>>(sizeof(mask)*ByteSize-HourLength)),
-    date>>(MinutePosition)&(mask>>(sizeof(mask)*ByteSize-MinuteLength)));  
+                                   cal.month,
+                                   cal.day,
+                                   cal.year,
+                                   cal.hour,
+                                   cal.minute);
   
   return;
 }
\ No newline at end of file
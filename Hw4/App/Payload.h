@@ -13,9 +13,14 @@ Handles the processing of packets
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Latency stamps follow the packet fields
+10-19-2026 dwt - Pack only the packet structure
+10-19-2026 dwt - Build default for the output mode
 */
 #include <includes.h>
 #include "BfrPair.h"
+#include "Signal.h"
+#include "Latency.h"
 
 #pragma pack(1) // Dont align on word boundaries
 
@@ -30,6 +35,10 @@ CHANGES
 #define TimeMsg 6
 #define PrecipMsg 7
 #define IDMsg 8
+#define QueryMsg 9    // Inbound history query
+#define HistoryMsg 10 // Outbound history reply
+#define CmdMsg 11     // Inbound diagnostic command
+#define NoMsg 0xFF    // Suppressed, nothing to display
 
 #define DEST_ADDR 1
 #define HeaderLength 4
@@ -42,6 +51,9 @@ CHANGES
 #define NibbleSize 4
 #define ByteMask 0xFF
 
+// Convert one packed BCD byte (two digits) to binary
+#define BcdToBin(b) ((((b)>>NibbleSize)*10) + ((b)&0x0F))
+
 // Wind Speed Packet
 #define SpeedDecimalMask 0x0F
 
@@ -88,24 +100,100 @@ typedef struct
   CPU_INT32U dateTime;
   CPU_INT08U depth[DepthSize];
   CPU_INT08U id[IdSize];
+  struct
+  {
+    CPU_INT08U node;
+    CPU_INT08U metric;
+    CPU_INT08U count;
+  } query;
+  struct
+  {
+    CPU_INT08U code;
+    CPU_INT08U arg;
+  } cmd;
   } dataPart;
+  LatStamps stamps;   // Set by the parser once the frame is good
 } Payload;
 
-// Size of buffer data spaces
+#pragma pack() // Align everything after the packet as usual
+
+/*----- M e t r i c s -----*/
+
+// One metric per numeric field of a reading
+#define TempMetric 0
+#define BaroMetric 1
+#define DewPtMetric 2
+#define HumMetric 3
+#define SpeedMetric 4
+#define DirMetric 5
+#define RadMetric 6
+#define PrecipMetric 7
+#define NumMetrics 8
+#define NoMetric 0xFF
+
+// Output modes
+#define OutputAll 0       // Every reading plus summaries
+#define OutputSummary 1   // Everything but readings: errors, replies, summaries
+
+// Output mode at power up; CmdOutputMode changes it
+#ifndef OutputMode
+#define OutputMode OutputAll
+#endif
+
+/*----- D e c o d e d   R e a d i n g -----*/
+
+// Most fields a message decodes into (humidity and wind have two)
+#define MaxFields 2
+
+// Numeric form of a packet: BCD and byte-swapped fields converted
+// to plain integers (wind speed in tenths, precip depth in hundredths).
+typedef struct
+{
+  CPU_INT08U srcAddr;
+  CPU_INT08U msgType;
+  CPU_INT08U numFields;           // 0 for messages with no numeric value
+  CPU_INT32S field[MaxFields];
+} Reading;
+
+// Most bytes of a frame a payload buffer holds; the stamps follow them
 #define PayloadBfrSize 14
 
-// Define the payload buffer pair.
-static BfrPair payloadBfrPair;
-static CPU_INT08U pBfr0Space[PayloadBfrSize];
-static CPU_INT08U pBfr1Space[PayloadBfrSize];
+// Size of the formatted message buffer
+#define MsgBfrSize 80
+
+// Render every ready payload per wakeup into one TX burst
+#ifndef PayloadBatch
+#define PayloadBatch 1
+#endif
+
+// Size of each lane's burst buffer
+#ifndef BurstSize
+#define BurstSize 1024
+#endif
+
+// Messages one lane's burst can hold
+#ifndef BurstMsgs
+#define BurstMsgs 32
+#endif
+
+// The payload buffer pair and its signals, defined in Payload.c
+extern BfrPair payloadBfrPair;
+extern Signal openPayloadBfrs;
+extern Signal closedPayloadBfrs;
 
-//Semaphores
-static OS_SEM openPayloadBfrs;
-static OS_SEM closedPayloadBfrs;
+// The payload task, posted directly by signals that use task semaphores
+extern OS_TCB payloadTCB;
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
 void PayloadInit(void);
 void PayloadTask(void *data);
+void DecodeReading(Payload *payload,Reading *reading);
+CPU_INT32U PayloadWakeups(void);
+CPU_INT32U PayloadFrames(void);
+CPU_INT08U MetricOf(CPU_INT08U msgType,CPU_INT08U field);
+const CPU_CHAR *MetricName(CPU_INT08U metric);
+void SetOutputMode(CPU_INT08U mode);
+CPU_INT08U GetOutputMode(void);
 void DisplayPrecip(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *depth);
 void DisplayWind(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT08U *speed,CPU_INT16U dir);
 void DisplayDate(CPU_INT08U *msgBfr,CPU_INT08U addr,CPU_INT32U date);
@@ -11,6 +11,11 @@ Read in data from serial io and pass them into a packet structure
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Reject lengths that would overrun the payload buffer
+10-19-2026 dwt - Debug echo goes through the deferred logger
+10-19-2026 dwt - Parse task created with stack checking
+10-19-2026 dwt - Wait on Signals, keep running after a packet
+10-19-2026 dwt - Latency stamps on each good frame
 */
 
 /* Include Micrium and STM headers. */
@@ -22,6 +27,9 @@ CHANGES
 #include "BfrPair.h"
 #include "SerIODriver.h"
 #include "Error.h"
+#include "Log.h"
+#include "Signal.h"
+#include "Latency.h"
 #include "assert.h"
 
 //----- c o n s t a n t    d e f i n i t  i o n s -----
@@ -33,7 +41,7 @@ CHANGES
 
 //----- g l o b a l    v a r i a b l e s -----
 
-static  OS_TCB   parseTCB;                     // Consumer task TCB
+        OS_TCB   parseTCB;                     // Consumer task TCB
 static  CPU_STK  parseStk[PARSE_STK_SIZE];  // Space for Parse task
 
 /*--------------- C r e a t e P a r s e T a s k ( ) ---------------*/
@@ -59,7 +67,7 @@ void CreateParseTask(void)
                0,                       // This task has no task queue
                0,                       // Number of clock ticks (defaults to 10)
                NULL,          // Pointer to TCB extension
-               0,                       // Task options
+               (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   // Task options
                &osErr);                 // Address to return O/S error code
     
   /* Verify successful task creation. */
@@ -79,32 +87,32 @@ CPU_VOID ParsePkt(CPU_VOID *data)
 {
   static ParserState state;
   static CPU_INT08U checksum;
+  static CPU_TS rxTs;     // When the frame's first byte came in
   CPU_INT16S c;
   static int i;
-  OS_ERR osErr;
-  
-  PktBfr *pktBfr = (PktBfr *) PutBfrAddr(&payloadBfrPair);
+  PktBfr *pktBfr;
   
   while(1)
   {
-    if(PutBfrClosed(&payloadBfrPair))
+    //a wakeup may be for another signal, so test again each time
+    while(PutBfrClosed(&payloadBfrPair))
     {
-      OSSemPend(&openPayloadBfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
-      assert(osErr==OS_ERR_NONE);
-      
       if(BfrPairSwappable(&payloadBfrPair))
         BfrPairSwap(&payloadBfrPair);
+      else
+        SignalPend(&openPayloadBfrs);
     }
-    
-    if(PutBfrClosed(&payloadBfrPair))
-      return;
+    //a swap moves the put buffer
+    pktBfr = (PktBfr *) PutBfrAddr(&payloadBfrPair);
     
     //Receive a byte
     c = GetByte();
-    BSP_Ser_Printf("%c",c);
+#if ParseEcho
+    Log1(TxBulk,"%c",c);
+#endif
     //Block waiting for next byte
     if(c<0)
-      return; 
+      continue;
     //XOR byte with current checksum
     checksum ^= c;
     
@@ -112,15 +120,17 @@ CPU_VOID ParsePkt(CPU_VOID *data)
     {
     case P1: //Preamble 1
       if(c == P1Char)
+      {
         state = P2;
+        rxTs = RxPreambleTs();
+      }
       else
       {
         //Error if wrong char
         pktBfr->payloadLen=P1Err;
         ClosePutBfr(&payloadBfrPair);
         
-        OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-        assert(osErr==OS_ERR_NONE);
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
         state = ER;
       }
@@ -134,8 +144,7 @@ CPU_VOID ParsePkt(CPU_VOID *data)
         pktBfr->payloadLen=P2Err;
         ClosePutBfr(&payloadBfrPair);
         
-        OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-        assert(osErr==OS_ERR_NONE);
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
         state = ER;
       }
@@ -149,8 +158,7 @@ CPU_VOID ParsePkt(CPU_VOID *data)
         pktBfr->payloadLen=P3Err;
         ClosePutBfr(&payloadBfrPair);
         
-        OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-        assert(osErr==OS_ERR_NONE);
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
         state = ER;
       }
@@ -163,8 +171,17 @@ CPU_VOID ParsePkt(CPU_VOID *data)
         pktBfr->payloadLen=SizeErr;
         ClosePutBfr(&payloadBfrPair);
         
-        OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-        assert(osErr==OS_ERR_NONE);
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
+        
+        state = ER;
+      }
+      else if(c - HeaderLength > PayloadBfrSize)
+      {
+        //Payload wouldn't fit in a payload buffer
+        pktBfr->payloadLen=OversizeErr;
+        ClosePutBfr(&payloadBfrPair);
+        
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
         state = ER;
       }
@@ -186,20 +203,21 @@ CPU_VOID ParsePkt(CPU_VOID *data)
       //Check that the final bitwise XOR of packet = 0
       if(!(checksum))
       {
+        //the stamps travel with the payload
+        ((Payload *) pktBfr)->stamps.rx = rxTs;
+        ((Payload *) pktBfr)->stamps.parsed = LatNow();
         ClosePutBfr(&payloadBfrPair);
         
-        OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-        assert(osErr==OS_ERR_NONE);
+        SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
         state=P1;
-        return;
+        break;
       }
       //Otherwise, report a checksum error
       pktBfr->payloadLen=CheckErr;
       ClosePutBfr(&payloadBfrPair);
       
-      OSSemPost(&closedPayloadBfrs,OS_OPT_POST_1,&osErr);
-      assert(osErr==OS_ERR_NONE);
+      SignalPost(&closedPayloadBfrs,OS_OPT_POST_NONE);
         
       state = ER;
       break;
@@ -210,6 +228,7 @@ CPU_VOID ParsePkt(CPU_VOID *data)
       if(c==P1Char)
       {
         state = ER2;
+        rxTs = RxPreambleTs();
         //Don't lose a checksum char!
         checksum ^= P1Char;
       }
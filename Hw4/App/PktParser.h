@@ -14,12 +14,17 @@ exported from the module "PktParser.c"
 
 CHANGES
 02-05-2015 dwt - File Created
+10-19-2026 dwt - Added ParseEcho
+10-19-2026 dwt - Export parseTCB for the signals it pends on
 */
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
 CPU_VOID ParsePkt(CPU_VOID *payloadBfrPair);
 void CreateParseTask(void);
 
+// The parse task, posted directly by signals that use task semaphores
+extern OS_TCB parseTCB;
+
 /*----- c o n s t a n t    d e f i n i t i o n s -----*/
 // General Defines
 #define ByteSize 8
@@ -36,9 +41,12 @@ void CreateParseTask(void);
 // Packet Length
 #define PacketMinLength 0x08
 
-/*----- t y p e    d e f i n i t i o n s -----*/
+// Echo every received byte through the deferred logger
+#ifndef ParseEcho
+#define ParseEcho 0
+#endif
 
-extern OS_SEM openPayloadBfrs;
+/*----- t y p e    d e f i n i t i o n s -----*/
 
 // Parser States //
 typedef enum {P1,P2,P3,L,D,C,ER,ER2,ER3} ParserState;
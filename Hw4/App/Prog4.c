@@ -17,15 +17,15 @@ CHANGES
 #include "Error.h"
 #include "PktParser.h"
 #include "SerIODriver.h"
+#include "Report.h"
+#include "Log.h"
+#include "os_app_hooks.h"
 #include "assert.h"
 /*----- c o n s t a n t    d e f i n i t i o n s -----*/
 
 #define Init_STK_SIZE 128      // Init task Priority
 #define Init_PRIO 2             // Init task Priority
 
-// Define RS232 baud rate.
-#define BaudRate 9600
-
 /*----- G l o b a l    V a r i a b l e s -----*/
 
 static  OS_TCB   initTCB;                         // Init task TCB
@@ -48,6 +48,11 @@ CPU_INT32S main()
     OSInit(&osErr);                /* Initialize BSP functions */
     assert(osErr==OS_ERR_NONE);
     
+#if OS_CFG_APP_HOOKS_EN > 0u
+    //Install the statistic, switch and idle hooks
+    App_OS_SetAllHooks();
+#endif
+    
     //Create init task
     OSTaskCreate(&initTCB,"Init Task",Init,NULL,Init_PRIO,&initStk[0],
                  Init_STK_SIZE/10,Init_STK_SIZE,0,0,0,
@@ -90,14 +95,21 @@ static void Init(void *p_arg)
     CPU_IntDisMeasMaxCurReset();
 
     // Initialize USART2.
-    BSP_Ser_Init(BaudRate);
+    BSP_Ser_Init(SerialBaud);
 
     // Initialize the serial I/O driver. 
     InitSerIO();    
     
+    // Start the deferred logger.
+    LogInit();
+    
     // Create and initialize the Payload Buffer Pair and the Reply Buffer
   // Pair.
     PayloadInit();
+    
+    // Start the periodic summary reports.
+    ReportInit();
+    
     CreateParseTask();
     
     // Delete the Init task.
@@ -0,0 +1,257 @@
+/*--------------- R e p o r t . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Low priority task that sends periodic reports. A uC/OS-III periodic
+timer signals the task once a second; each report keeps its own
+interval and sends only when that interval expires.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the TX lane latency report
+10-19-2026 dwt - Report what the overload policy has shed
+10-19-2026 dwt - Added the error summary
+10-19-2026 dwt - Report log entries dropped
+10-19-2026 dwt - Added the task monitor record
+10-19-2026 dwt - Send requested trace dumps
+10-19-2026 dwt - Added the idle report
+10-19-2026 dwt - Added the signal report
+10-19-2026 dwt - Report RX buffer closes and parser wakeups
+10-19-2026 dwt - Report RX jitter and the worst interrupt disable time
+10-19-2026 dwt - Send requested ISR histograms
+10-19-2026 dwt - Report RX errors and backpressure
+10-19-2026 dwt - Report flow control pauses
+10-19-2026 dwt - Send requested latency histograms
+10-19-2026 dwt - Report readings the deadband table suppressed
+10-19-2026 dwt - Overruns reported as events, not bytes
+10-19-2026 dwt - Report readings with no node slot or no history
+*/
+
+#include "includes.h"
+#include "Report.h"
+#include "Stats.h"
+#include "SerIODriver.h"
+#include "TxQueue.h"
+#include "NodeTable.h"
+#include "History.h"
+#include "Error.h"
+#include "Log.h"
+#include "Monitor.h"
+#include "Trace.h"
+#include "Idle.h"
+#include "Signal.h"
+#include "IsrHist.h"
+#include "Latency.h"
+#include "assert.h"
+
+// -----c o n s t a n t    d e f i n i t i o n s -----
+
+#define SuspendTimeout 0	    // Timeout for semaphore wait
+#define REPORT_STK_SIZE 256   // Report task stack size
+#define ReportPrio 6          // Report task Priority
+
+// Report tick period in timer task ticks (one second)
+#define ReportPeriod OS_CFG_TMR_TASK_RATE_HZ
+
+// OS ticks to milliseconds
+#define TicksToMs(t) ((t) * 1000 / OS_CFG_TICK_RATE_HZ)
+
+#define LaneLineSize 144
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static  OS_TCB   reportTCB;                     // Report task TCB
+static  CPU_STK  reportStk[REPORT_STK_SIZE];    // Space for Report task stack
+static  OS_TMR   reportTmr;                     // Once a second report tick
+static  CPU_INT16U laneSecsLeft = LaneReportSec; // Until the next lane report
+
+static const CPU_CHAR *laneNames[NumTxLanes] = { "HIGH", "BULK" };
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void ReportTick(void *p_tmr,void *p_arg);
+static void LaneReport(void);
+
+/*--------------- R e p o r t I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Create the report task and start the report timer.
+*/
+void ReportInit(void)
+{
+  OS_ERR osErr;
+  
+  StatsInit();
+  
+  //create report task
+  OSTaskCreate(&reportTCB,             // Task Control Block
+               "Report Task",          // Task name
+               ReportTask,             // Task entry point
+               NULL,                   // Address of optional task data block
+               ReportPrio,             // Task priority
+               &reportStk[0],          // Base address of task stack space
+               REPORT_STK_SIZE / 10,   // Stack water mark limit
+               REPORT_STK_SIZE,        // Task stack size
+               0,                      // This task has no task queue
+               0,                      // Number of clock ticks (defaults to 10)
+               NULL,                   // Pointer to TCB extension
+               (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   // Task options
+               &osErr);
+  assert(osErr==OS_ERR_NONE);
+  
+  //create and start the periodic report timer
+  OSTmrCreate(&reportTmr,"Report Timer",ReportPeriod,ReportPeriod,
+              OS_OPT_TMR_PERIODIC,ReportTick,NULL,&osErr);
+  assert(osErr==OS_ERR_NONE);
+  
+  OSTmrStart(&reportTmr,&osErr);
+  assert(osErr==OS_ERR_NONE);
+}
+
+/*--------------- R e p o r t T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Wait for the report tick and give each report its turn.
+*/
+void ReportTask(void *data)
+{
+  OS_ERR osErr;
+  
+  for(;;)
+  {
+    OSTaskSemPend(SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+    assert(osErr==OS_ERR_NONE);
+    
+    StatsReport();
+    ErrorReport();
+    LaneReport();
+    MonitorReport();
+    TracePoll();
+    IsrHistPoll();
+    LatencyPoll();
+    IdleReport();
+    SignalReport();
+  }
+}
+
+/*--------------- L a n e R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Once every LaneReportSec seconds, send how long messages on each TX
+lane have waited to start going out, what the overload policy has
+given up, including deferred log entries, and the readings of each
+type the deadband table held back as unchanged. Also send the readings
+from nodes that found every slot taken or whose slot has no history,
+how many RX buffers the ISR closed and how many of them had to wake
+the parser, the worst RX jitter and the longest time interrupts were
+disabled, and the RX bytes lost and time spent with RX masked by a full
+buffer.
+*/
+static void LaneReport(void)
+{
+  CPU_CHAR line[LaneLineSize];
+  CPU_INT08U lane;
+  CPU_INT32U sent;
+  OS_TICK avgTicks;
+  OS_TICK maxTicks;
+  CPU_INT32U oldest;
+  CPU_INT32U newest;
+  CPU_INT32U summarized;
+  CPU_INT32U closes;
+  CPU_INT32U posts;
+  CPU_INT32U bytes;
+  CPU_TS jitter;
+  RxHealth rx;
+  
+  if(--laneSecsLeft > 0)
+    return;
+  laneSecsLeft = LaneReportSec;
+  
+  for(lane=0;lane<NumTxLanes;lane++)
+  {
+    TxLaneLatency(lane,&sent,&avgTicks,&maxTicks);
+    sprintf(line,"\n TX LANE %s: %lu MSGS, WAIT AVG %lu MS, MAX %lu MS\n",
+                 laneNames[lane],
+                 (unsigned long) sent,
+                 (unsigned long) TicksToMs(avgTicks),
+                 (unsigned long) TicksToMs(maxTicks));
+    PutMsg(line);
+  }
+  
+  TxQueueDrops(&oldest,&newest,&summarized);
+  sprintf(line," TX SHED: %lu OLDEST, %lu NEW, %lu SUMMARIZED, %lu LOG\n",
+               (unsigned long) oldest,
+               (unsigned long) newest,
+               (unsigned long) summarized,
+               (unsigned long) LogDropped());
+  PutMsg(line);
+  
+  sprintf(line," SUPPRESSED: %lu TEMP, %lu BARO, %lu HUM, %lu WIND, %lu RAD, "
+               "%lu TIME, %lu PRECIP\n",
+               (unsigned long) NodeTableSuppressed(TempMsg),
+               (unsigned long) NodeTableSuppressed(BaroMsg),
+               (unsigned long) NodeTableSuppressed(HumMsg),
+               (unsigned long) NodeTableSuppressed(WindMsg),
+               (unsigned long) NodeTableSuppressed(RadMsg),
+               (unsigned long) NodeTableSuppressed(TimeMsg),
+               (unsigned long) NodeTableSuppressed(PrecipMsg));
+  PutMsg(line);
+  
+  sprintf(line," NODE SLOTS: %u OF %u USED, %lu READINGS WITH NONE, "
+               "%lu NOT IN HISTORY\n",
+               (unsigned) NumNodeSlots(),
+               (unsigned) NodeSlots,
+               (unsigned long) NodeSlotsFull(),
+               (unsigned long) HistoryUnrecorded());
+  PutMsg(line);
+  
+  RxWakeups(&closes,&posts);
+  sprintf(line," RX WAKE: %lu BUFFERS CLOSED, %lu PARSER POSTS\n",
+               (unsigned long) closes,
+               (unsigned long) posts);
+  PutMsg(line);
+  
+  //compare builds with and without OS_CFG_ISR_POST_DEFERRED_EN
+  RxJitter(&bytes,&jitter);
+  sprintf(line," RX %s POSTS: JITTER MAX %lu TS OVER %lu BYTES, INT DIS MAX %lu TS\n",
+               SerialPostDeferred ? "DEFERRED" : "DIRECT",
+               (unsigned long) jitter,
+               (unsigned long) bytes,
+               (unsigned long) CPU_IntDisMeasMaxCurReset());
+  PutMsg(line);
+  
+  RxHealthGet(&rx);
+  sprintf(line," RX LOST: %lu OVERRUN EVENTS, %lu FRAMING, %lu NOISE\n",
+               (unsigned long) rx.overruns,
+               (unsigned long) rx.framing,
+               (unsigned long) rx.noise);
+  PutMsg(line);
+  sprintf(line," RX MASKED: %lu TIMES, AVG %lu TS, MAX %lu TS; %lu PAUSES\n",
+               (unsigned long) rx.masks,
+               (unsigned long)(rx.masks ? rx.maskedTs / rx.masks : 0),
+               (unsigned long) rx.maskedMax,
+               (unsigned long) rx.pauses);
+  PutMsg(line);
+}
+
+/*--------------- R e p o r t T i c k ( ) ---------------*/
+
+/*
+PURPOSE
+Timer callback: wake the report task. Runs in the timer task, so the
+reports themselves are never formatted here.
+*/
+static void ReportTick(void *p_tmr,void *p_arg)
+{
+  OS_ERR osErr;
+  
+  OSTaskSemPost(&reportTCB,OS_OPT_POST_NONE,&osErr);
+}
@@ -0,0 +1,32 @@
+#ifndef __report__
+#define __report__
+/*--------------- R e p o r t . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Report.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the TX lane latency report
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Seconds between TX lane latency reports
+#ifndef LaneReportSec
+#define LaneReportSec 60
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void ReportInit(void);
+void ReportTask(void *data);
+
+#endif
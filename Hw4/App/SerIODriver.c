@@ -3,20 +3,100 @@
 #include "SerIODriver.h"
 #include "BfrPair.h"
 #include "Buffer.h"
+#include "Signal.h"
+#include "PktParser.h"
+#include "Intrpt.h"
+#include "IsrHist.h"
+#include "Latency.h"
 #include "stm32f10x_map.h"
 #include "assert.h"
 
 #define SETENA1 (*((CPU_INT32U *) 0xE000E104))
+#define IPR38 (*((CPU_INT08U *) 0xE000E426))    // IRQ38 priority
 #define USART2ENA 0x00000040
 #define USARTINIT 0x20AC
 #define TXIEENA 0x80
 #define RXIEENA 0x20
+
+#if SerialPrio >= IntMaskPrio
+#error "SerialPrio must be above IntMaskPrio"
+#endif
+
+// One output lane: its own buffer pair plus the lengths of the messages
+// queued on it, so ServiceTx() can switch lanes only between messages.
+typedef struct
+{
+  BfrPair bfrPair;                  // Bytes waiting to go out on this lane
+  CPU_INT08U bfr0Space[BfrSize];
+  CPU_INT08U bfr1Space[BfrSize];
+  OS_SEM openBfrs;                  // Posted when the ISR frees space
+  OS_MUTEX mutex;                   // Keeps messages on the lane whole
+  CPU_INT16U msgLen[TxMsgQSize];    // Lengths of the queued messages
+  OS_TICK queuedAt[TxMsgQSize];     // Tick each message was queued
+  LatStamps stamps[TxMsgQSize];     // Pipeline stamps of each message
+  CPU_BOOLEAN stamped[TxMsgQSize];  // ... if it came from a packet
+  CPU_INT08U msgHead;               // Oldest queued message
+  volatile CPU_INT08U numMsgs;      // Queued messages, including in flight
+  CPU_INT32U sent;                  // Messages started since power up
+  CPU_INT32U waitSum;               // Total queueing time in ticks
+  OS_TICK waitMax;                  // Longest queueing time in ticks
+} TxLane;
+
+// Posted to the parser when the RX put buffer closes while it sleeps
+static Signal closedIBfrs;
+static volatile CPU_BOOLEAN rxSleeping;   // Parser pending on closedIBfrs
+static CPU_INT32U rxCloses;               // RX put buffers closed
+static CPU_INT32U rxPosts;                // ... and posts they needed
+
+// RX timing: back to back bytes should be serviced one byte time apart
+static CPU_TS rxByteTs;                   // One byte time in CPU_TS counts
+static CPU_TS rxLastTs;                   // When the last byte was read
+static CPU_INT32U rxBackToBack;           // Bytes that followed another
+static CPU_TS rxJitterMax;                // Worst miss of the byte time
+static CPU_TS rxArrival;                  // Latest byte's arrival, at most
+static CPU_TS isrEntryTs;                 // When SerialISR was entered
+
+// LatNow() as ServiceRx() read each preamble byte still in the RX
+// buffers, oldest at rxP1Get; GetByte() takes them in the same order
+static CPU_TS rxP1Ts[RxP1Stamps];
+static CPU_INT16U rxP1Put;
+static CPU_INT16U rxP1Get;
+static CPU_TS rxP1Last;                   // Last preamble byte returned
+
+// RX losses, and RXIE masking by a full put buffer
+static RxHealth rxHealth;
+static volatile CPU_BOOLEAN rxMasked;     // RXIE masked by ServiceRx
+static CPU_TS rxMaskedAt;                 // ... since this time
+
+#if RxFlow != FlowNone
+static volatile CPU_BOOLEAN rxPaused;     // Sender asked to stop
+#endif
+#if RxFlow == FlowXonXoff
+static volatile CPU_INT08U txFlowChar;    // XON or XOFF to send next, or 0
+#endif
+
+static TxLane txLanes[NumTxLanes];
+static TxLane *txLane;              // Lane owning the message in flight
+static CPU_INT16U txRemain;         // Bytes of that message still to send
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void QueueMsg(TxLane *lane,CPU_INT16U len,LatStamps *stamps);
+static void LanePutByte(TxLane *lane,CPU_INT08U c);
+static void LaneRelease(TxLane *lane);
+static void RxUnmasked(CPU_TS masked);
+#if RxFlow != FlowNone
+static CPU_INT16U RxOccupancy(void);
+static void RxFlowResume(void);
+static void RxFlowSend(CPU_BOOLEAN pause);
+#endif
+
 /*--------------- I n i t S e r I O ( ) ---------------
 
 PURPOSE
 Initialize the RS232 I/O driver by
-initializing both iBfrPair and
-oBfrPair.
+initializing iBfrPair and the buffer
+pair of every output lane.
 
 INPUT PARAMETERS
 none
@@ -24,60 +104,432 @@ none
 void InitSerIO(void)
 {
   OS_ERR osErr;
+  CPU_ERR cpuErr;
+  TxLane *lane;
   
-  //init output and input buffer pairs
-  BfrPairInit(&iBfrPair,iBfr0Space,iBfr1Space,BfrSize);
-  BfrPairInit(&oBfrPair,oBfr0Space,oBfr1Space,BfrSize);
+  rxByteTs = CPU_TS_TmrFreqGet(&cpuErr) / SerialBaud * BitsPerByte;
+  
+  //init input buffer pair and the output lanes
+  BfrPairInit(&iBfrPair,iBfr0Space,iBfr1Space,RxBfrSize);
+  for(lane = txLanes;lane < txLanes+NumTxLanes;lane++)
+  {
+    BfrPairInit(&lane->bfrPair,lane->bfr0Space,lane->bfr1Space,BfrSize);
+    
+    OSSemCreate(&lane->openBfrs,"Open oBfrs",0,&osErr);
+    assert(osErr==OS_ERR_NONE);
+    
+    OSMutexCreate(&lane->mutex,"TX Lane Mutex",&osErr);
+    assert(osErr==OS_ERR_NONE);
+  }
+  
+#if RxFlow == FlowRtsCts
+  //RTS as an output, ready to receive; let CTS hold off TX
+  RtsOn();
+  RtsInit();
+  USART2->CR3 |= CTSE;
+#endif
   
   //enable uart, tx, rx, tx interrupt, rx interrupt
   USART2->CR1 |= USARTINIT;
     
-  //enable IRQ38
+  //enable IRQ38, above anything IntMask() holds off
+  IPR38 = SerialPrio;
   SETENA1 = USART2ENA;
   
-  //Create semaphore openObfrs=2
-  OSSemCreate(&openObfrs,"Open oBfrs",2,&osErr);
-  assert(osErr==OS_ERR_NONE);
-
-  //Create semaphore closedIBfrs=0
-  OSSemCreate(&closedIBfrs,"Closed iBfrs",0,&osErr);
-  assert(osErr==OS_ERR_NONE);  
-  
+  //Create signal closedIBfrs=0, pended on by the parser
+  SignalCreate(&closedIBfrs,"Closed iBfrs",0,&parseTCB);
 }
 
 /*--------------- P u t B y t e ( ) ---------------
 
 PURPOSE
-If the oBfrPair put buffer is not full, write one byte into the buffer, and
-return txChar as the return value; if, the buffer is full, return -1 indicating
-failure.
+Send a single byte on the bulk lane as a message of its own.
 
 INPUT PARAMETERS
 txChar - the byte to be transmitted
 
 RETURN VALUE
-On success, PutByte() returns the character in "txChar that was added to
-the put buffer. If the put buffer is already full, txChar returns 1 to indicate
-failure.
+The character in "txChar.
 */
 CPU_INT16S PutByte(CPU_INT16S txChar)
+{
+  CPU_INT08U c = txChar;
+  
+  PutLaneBlock(TxBulk,&c,1);
+  
+  return txChar;
+}
+
+/*--------------- P u t M s g ( ) ---------------
+
+PURPOSE
+Write a null terminated message to the bulk lane. Messages from
+different tasks are never interleaved.
+
+INPUT PARAMETERS
+msg - the message string
+*/
+void PutMsg(CPU_CHAR *msg)
+{
+  PutLaneMsg(TxBulk,msg);
+}
+
+/*--------------- P u t B l o c k ( ) ---------------
+
+PURPOSE
+Write a binary message to the bulk lane as one unit.
+
+INPUT PARAMETERS
+data - the message bytes
+len  - the number of bytes
+*/
+void PutBlock(CPU_INT08U *data,CPU_INT16U len)
+{
+  PutLaneBurst(TxBulk,data,&len,1,NULL);
+}
+
+/*--------------- P u t L a n e M s g ( ) ---------------
+
+PURPOSE
+Write a null terminated message to the given lane.
+
+INPUT PARAMETERS
+lane - TxHigh or TxBulk
+msg  - the message string
+*/
+void PutLaneMsg(CPU_INT08U lane,CPU_CHAR *msg)
+{
+  PutLaneBlock(lane,(CPU_INT08U *) msg,Str_Len(msg));
+}
+
+/*--------------- P u t L a n e B l o c k ( ) ---------------
+
+PURPOSE
+Write a binary message to the given lane as one unit.
+
+INPUT PARAMETERS
+lane - TxHigh or TxBulk
+data - the message bytes
+len  - the number of bytes
+*/
+void PutLaneBlock(CPU_INT08U lane,CPU_INT08U *data,CPU_INT16U len)
+{
+  PutLaneBurst(lane,data,&len,1,NULL);
+}
+
+/*--------------- P u t L a n e B u r s t ( ) ---------------
+
+PURPOSE
+Write several back to back messages to the given lane while holding
+the lane once. Each message is queued with its own length, so a
+higher priority lane can still go out between any two of them.
+
+INPUT PARAMETERS
+lane    - TxHigh or TxBulk
+data    - the message bytes, one message after another
+msgLens - the length of each message
+numMsgs - the number of messages
+stamps  - the pipeline stamps of each message, or NULL if the messages
+          did not come from packets and are not to be timed
+*/
+void PutLaneBurst(CPU_INT08U lane,CPU_INT08U *data,
+                  CPU_INT16U *msgLens,CPU_INT08U numMsgs,
+                  LatStamps *stamps)
 {
   OS_ERR osErr;
+  TxLane *txl = &txLanes[lane];
+  CPU_INT16U len;
+  
+  OSMutexPend(&txl->mutex,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+  assert(osErr==OS_ERR_NONE);
   
-  if(PutBfrClosed(&oBfrPair))
+  while(numMsgs-- > 0)
   {
-    //pend on open obfrs
-    OSSemPend(&openObfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
-    assert(osErr==OS_ERR_NONE);
+    len = *msgLens++;
+    if(len==0)
+    {
+      if(stamps != NULL)
+        stamps++;
+      continue;
+    }
     
-    //try to swap
-    if(BfrPairSwappable(&oBfrPair))
-      BfrPairSwap(&oBfrPair);
+    QueueMsg(txl,len,stamps);
+    if(stamps != NULL)
+      stamps++;
+    while(len-- > 0)
+      LanePutByte(txl,*data++);
+    
+    //close the partial buffer so the message end goes out now
+    if(!PutBfrEmpty(&txl->bfrPair) && !PutBfrClosed(&txl->bfrPair))
+    {
+      ClosePutBfr(&txl->bfrPair);
+      LaneRelease(txl);
+    }
   }
-  //unmask TX interrupt
-  USART2->CR1 |= TXIEENA;   
   
-  return PutBfrAddByte(&oBfrPair,txChar);
+  OSMutexPost(&txl->mutex,OS_OPT_POST_NONE,&osErr);
+  assert(osErr==OS_ERR_NONE);
+}
+
+/*--------------- T x L a n e L a t e n c y ( ) ---------------
+
+PURPOSE
+Report how long messages on a lane have waited between being queued
+and their first byte reaching the UART.
+
+INPUT PARAMETERS
+lane     - TxHigh or TxBulk
+sent     - returns the number of messages started
+avgTicks - returns the average wait in OS ticks
+maxTicks - returns the longest wait in OS ticks
+*/
+void TxLaneLatency(CPU_INT08U lane,CPU_INT32U *sent,
+                   OS_TICK *avgTicks,OS_TICK *maxTicks)
+{
+  TxLane *txl = &txLanes[lane];
+  CPU_INT32U waitSum;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  *sent = txl->sent;
+  waitSum = txl->waitSum;
+  *maxTicks = txl->waitMax;
+  CPU_CRITICAL_EXIT();
+  
+  *avgTicks = (*sent > 0) ? waitSum / *sent : 0;
+}
+
+/*--------------- R x W a k e u p s ( ) ---------------
+
+PURPOSE
+Report how many RX put buffers the ISR has closed and how many of
+those closes had to post the parser awake. The rest were picked up
+by a parser that had not yet gone to sleep.
+
+INPUT PARAMETERS
+closes - returns the number of RX put buffers closed
+posts  - returns the number of posts to the parser
+*/
+void RxWakeups(CPU_INT32U *closes,CPU_INT32U *posts)
+{
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  *closes = rxCloses;
+  *posts = rxPosts;
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- R x J i t t e r ( ) ---------------
+
+PURPOSE
+Report how far the RX service times of back to back bytes strayed from
+one byte time apart since the last call, and start again. Interrupts
+held off by kernel or application critical sections show up here.
+
+INPUT PARAMETERS
+bytes     - returns the number of back to back bytes measured
+maxJitter - returns the worst difference from one byte time, CPU_TS
+*/
+void RxJitter(CPU_INT32U *bytes,CPU_TS *maxJitter)
+{
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  *bytes = rxBackToBack;
+  *maxJitter = rxJitterMax;
+  rxBackToBack = 0;
+  rxJitterMax = 0;
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- R x H e a l t h G e t ( ) ---------------
+
+PURPOSE
+Report the RX bytes lost or damaged, and how often and how long a full
+put buffer kept RXIE masked. Overruns while masked mean a stalled
+parser cost input.
+
+INPUT PARAMETERS
+health - returns the counts since power up
+*/
+void RxHealthGet(RxHealth *health)
+{
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  *health = rxHealth;
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- R x P r e a m b l e T s ( ) ---------------
+
+PURPOSE
+Report when ServiceRx() read the last preamble byte GetByte() returned,
+the first stamp of a packet's latency trace.
+
+RETURN VALUE
+LatNow() as the byte was read
+*/
+CPU_TS RxPreambleTs(void)
+{
+  return rxP1Last;
+}
+
+/*--------------- R x U n m a s k e d ( ) ---------------
+
+PURPOSE
+Account for one stretch of RXIE masked by backpressure. Called with
+interrupts disabled.
+
+INPUT PARAMETERS
+masked - how long RXIE was masked, CPU_TS
+*/
+static void RxUnmasked(CPU_TS masked)
+{
+  rxHealth.maskedTs += masked;
+  if(masked > rxHealth.maskedMax)
+    rxHealth.maskedMax = masked;
+}
+
+#if RxFlow != FlowNone
+/*--------------- R x O c c u p a n c y ( ) ---------------
+
+PURPOSE
+Measure how full the RX buffers are for flow control. The get buffer
+counts as full unless the parser is waiting for the next one: even
+empty, the ISR can't use it until the parser swaps it in as the put
+buffer, and a parser held up downstream won't.
+
+RETURN VALUE
+Bytes held, from 0 to 2*RxBfrSize
+*/
+static CPU_INT16U RxOccupancy(void)
+{
+  return PutBfrCount(&iBfrPair) + (rxSleeping ? 0 : RxBfrSize);
+}
+
+/*--------------- R x F l o w R e s u m e ( ) ---------------
+
+PURPOSE
+Let the sender go again if it is paused and the RX buffers have
+drained to RxLowWater. Called with interrupts disabled.
+*/
+static void RxFlowResume(void)
+{
+  if(rxPaused && RxOccupancy() <= RxLowWater)
+  {
+    rxPaused = DEF_FALSE;
+    RxFlowSend(DEF_FALSE);
+  }
+}
+
+/*--------------- R x F l o w S e n d ( ) ---------------
+
+PURPOSE
+Tell the sender to pause or resume, by RTS or by XOFF/XON. Called from
+ServiceRx() or with interrupts disabled.
+
+INPUT PARAMETERS
+pause - TRUE to pause, FALSE to resume
+*/
+static void RxFlowSend(CPU_BOOLEAN pause)
+{
+#if RxFlow == FlowRtsCts
+  if(pause)
+    RtsOff();
+  else
+    RtsOn();
+#elif RxFlow == FlowXonXoff
+  //an XOFF not yet sent is simply replaced
+  txFlowChar = pause ? XOFF : XON;
+  USART2->CR1 |= TXIEENA;
+#endif
+}
+#endif
+
+/*--------------- Q u e u e M s g ( ) ---------------
+
+PURPOSE
+Record the length of the next message on a lane, waiting for the
+ISR to retire a message if the lane's queue is full.
+
+INPUT PARAMETERS
+lane   - the lane
+len    - the message length in bytes
+stamps - the message's pipeline stamps, or NULL
+*/
+static void QueueMsg(TxLane *lane,CPU_INT16U len,LatStamps *stamps)
+{
+  OS_ERR osErr;
+  CPU_INT08U slot;
+  CPU_SR_ALLOC();
+  
+  while(lane->numMsgs >= TxMsgQSize)
+  {
+    OSSemPend(&lane->openBfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+    assert(osErr==OS_ERR_NONE);
+  }
+  
+  CPU_CRITICAL_ENTER();
+  slot = (lane->msgHead + lane->numMsgs) % TxMsgQSize;
+  lane->msgLen[slot] = len;
+  lane->queuedAt[slot] = OSTimeGet(&osErr);
+  lane->stamped[slot] = (stamps != NULL);
+  if(stamps != NULL)
+    lane->stamps[slot] = *stamps;
+  lane->numMsgs++;
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- L a n e P u t B y t e ( ) ---------------
+
+PURPOSE
+Add one byte to a lane's put buffer, waiting for the ISR to free a
+buffer if both are closed. A buffer that fills is handed to the ISR.
+
+INPUT PARAMETERS
+lane - the lane
+c    - the byte to be transmitted
+*/
+static void LanePutByte(TxLane *lane,CPU_INT08U c)
+{
+  OS_ERR osErr;
+  
+  //the semaphore is only a wake up; recheck after every post
+  while(PutBfrClosed(&lane->bfrPair))
+  {
+    OSSemPend(&lane->openBfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+    assert(osErr==OS_ERR_NONE);
+  }
+  
+  PutBfrAddByte(&lane->bfrPair,c);
+  
+  if(PutBfrClosed(&lane->bfrPair))
+    LaneRelease(lane);
+}
+
+/*--------------- L a n e R e l e a s e ( ) ---------------
+
+PURPOSE
+Hand a closed put buffer to the ISR: swap it in now if the get buffer
+is free, and unmask the TX interrupt. If the get buffer is still busy,
+ServiceTx() swaps when it drains.
+
+INPUT PARAMETERS
+lane - the lane
+*/
+static void LaneRelease(TxLane *lane)
+{
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  if(BfrPairSwappable(&lane->bfrPair))
+    BfrPairSwap(&lane->bfrPair);
+  
+  //unmask TX interrupt
+  USART2->CR1 |= TXIEENA;
+  CPU_CRITICAL_EXIT();
 }
 
 /*--------------- G e t B y t e ( ) ---------------
@@ -96,31 +548,73 @@ returns 
 */
 CPU_INT16S GetByte(void)
 { 
-  OS_ERR osErr;
+  CPU_INT16S c;
+  CPU_SR_ALLOC();
   
-  if(!GetBfrClosed(&iBfrPair))
+  //a wakeup may be for another signal, so test again each time
+  while(!GetBfrClosed(&iBfrPair))
   {
-    OSSemPend(&closedIBfrs,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
-    assert(osErr==OS_ERR_NONE);
+    //the ISR posts only if it sees rxSleeping, so decide to sleep
+    //with the RX interrupt held off: a close can't slip in between
+    CPU_CRITICAL_ENTER();
+    rxSleeping = !BfrPairSwappable(&iBfrPair);
+#if RxFlow != FlowNone
+    //a waiting parser frees the get buffer; a paused sender must go
+    //again, or the put buffer never closes to wake it
+    RxFlowResume();
+#endif
+    CPU_CRITICAL_EXIT();
     
-    if(BfrPairSwappable(&iBfrPair))
+    if(rxSleeping)
+      SignalPend(&closedIBfrs);
+    else
+    {
       BfrPairSwap(&iBfrPair);
+      
+      //the ISR has an open put buffer again, so unmask RX interrupt if
+      //a full one masked it; only the ISR sets rxMasked, and only
+      //while RXIE is on
+      if(rxMasked)
+      {
+        CPU_CRITICAL_ENTER();
+        RxUnmasked(CPU_TS_Get32() - rxMaskedAt);
+        rxMasked = DEF_FALSE;
+        USART2->CR1 |= RXIEENA;
+        CPU_CRITICAL_EXIT();
+      }
+    }
   }
-  if(GetBfrClosed(&iBfrPair))
+  
+#if RxFlow != FlowNone
+  //let the sender go again once the parser has caught up
+  if(rxPaused)
   {
-    //unmask TX interrupt
-    USART2->CR1 |= RXIEENA;
+    CPU_CRITICAL_ENTER();
+    RxFlowResume();
+    CPU_CRITICAL_EXIT();
   }
+#endif
   
-  return GetBfrRemByte(&iBfrPair);
+  c = GetBfrRemByte(&iBfrPair);
+  
+  //ServiceRx() stamped every preamble byte in the buffers, in order
+  if(c == P1Char)
+  {
+    rxP1Last = rxP1Ts[rxP1Get];
+    if(++rxP1Get == RxP1Stamps)
+      rxP1Get = 0;
+  }
+  
+  return c;
 }
 
 /*--------------- S e r v i c e T x ( ) ---------------
 
 PURPOSE
-If TXE = 1 and the oBfrPair get buffer is closed, then output one byte
-to the UART Tx and return. If TXE = 0, just return. If the get buffer is
-not closed mask the Tx and return
+If TXE = 1, output one byte of the message in flight. Between messages,
+pick the highest priority lane with a message queued, so a lane only
+changes at a message boundary. If TXE = 0, just return. If nothing is
+ready to send, mask the Tx and return.
 
 INPUT PARAMETERS
 none
@@ -129,18 +623,57 @@ void ServiceTx(void)
 {
   CPU_INT16S c;
   OS_ERR osErr;
+  TxLane *lane;
+  OS_TICK wait;
+  CPU_BOOLEAN freed = FALSE;
   
   if(USART2->SR & USART_TXE)
   {
-    if(!GetBfrClosed(&oBfrPair))
+#if RxFlow == FlowXonXoff
+    //flow control goes out ahead of everything, even mid message
+    if(txFlowChar != 0)
     {
-      //mask TX interrupt
-      USART2->CR1 = TXIEENA^USARTINIT;
+      USART2->DR = txFlowChar;
+      txFlowChar = 0;
       
       return;
     }
+#endif
     
-    c = GetBfrRemByte(&oBfrPair);
+    if(txRemain==0)
+    {
+      //message boundary, lower lane numbers go first
+      for(lane = txLanes;lane < txLanes+NumTxLanes;lane++)
+        if(lane->numMsgs > 0)
+          break;
+      
+      if(lane==txLanes+NumTxLanes)
+      {
+        //mask TX interrupt
+        USART2->CR1 &= ~TXIEENA;
+        
+        return;
+      }
+      
+      txLane = lane;
+      txRemain = lane->msgLen[lane->msgHead];
+      
+      wait = OSTimeGet(&osErr) - lane->queuedAt[lane->msgHead];
+      lane->sent++;
+      lane->waitSum += wait;
+      if(wait > lane->waitMax)
+        lane->waitMax = wait;
+    }
+    
+    if(!GetBfrClosed(&txLane->bfrPair))
+    {
+      //the producer is still writing this message
+      USART2->CR1 &= ~TXIEENA;
+      
+      return;
+    }
+    
+    c = GetBfrRemByte(&txLane->bfrPair);
     
     //buffer empty?
     if(c==-1)
@@ -149,10 +682,30 @@ void ServiceTx(void)
     }
     //Ok to output
     USART2->DR = c;
+    txRemain--;
     
-    if(!GetBfrClosed(&oBfrPair))
+    if(!GetBfrClosed(&txLane->bfrPair))
     {
-      OSSemPost(&openObfrs,OS_OPT_POST_1,&osErr);
+      //take the next closed buffer straight away
+      if(BfrPairSwappable(&txLane->bfrPair))
+        BfrPairSwap(&txLane->bfrPair);
+      freed = TRUE;
+    }
+    
+    if(txRemain==0)
+    {
+      //the last byte is out; time the message through the pipeline
+      if(txLane->stamped[txLane->msgHead])
+        LatencyDone(&txLane->stamps[txLane->msgHead]);
+      
+      txLane->msgHead = (txLane->msgHead + 1) % TxMsgQSize;
+      txLane->numMsgs--;
+      freed = TRUE;
+    }
+    
+    if(freed)
+    {
+      OSSemPost(&txLane->openBfrs,OS_OPT_POST_1,&osErr);
       assert(osErr==OS_ERR_NONE);
     }
     
@@ -162,7 +715,6 @@ void ServiceTx(void)
   return;
 }
 
-
 /*--------------- S e r v i c e R x ( ) ---------------
 
 PURPOSE
@@ -176,27 +728,91 @@ none
 void ServiceRx(void)
 {
   CPU_INT16S c;
-  OS_ERR osErr;
+  CPU_INT16U sr = USART2->SR;
+  CPU_TS now;
+  CPU_TS gap;
   
-  if(USART2->SR & USART_RXNE)
+  if(sr & USART_RXNE)
   {
-    //if buffer is full, return
+    //if buffer is full, mask RX until GetByte() frees one, and return
     if(PutBfrClosed(&iBfrPair))
     {
       USART2->CR1 &= RXIEENA^USARTINIT;
+      if(!rxMasked)
+      {
+        rxMasked = DEF_TRUE;
+        rxMaskedAt = isrEntryTs;
+        rxHealth.masks++;
+      }
       
       return;
     }
     
+    //reading SR and then DR clears the error flags
+    if(sr & USART_ORE)
+      rxHealth.overruns++;
+    if(sr & USART_FE)
+      rxHealth.framing++;
+    if(sr & USART_NE)
+      rxHealth.noise++;
+    
     //now we are ready to get a byte
     c = USART2->DR;
+    
+#if RxFlow != FlowNone
+    //ask the sender to stop while there is still room for the bytes
+    //already on their way
+    if(!rxPaused && RxOccupancy() + 1 >= RxHighWater)
+    {
+      rxPaused = DEF_TRUE;
+      rxHealth.pauses++;
+      RxFlowSend(DEF_TRUE);
+    }
+#endif
+    
+    //a byte within two byte times of the last one followed it directly
+    now = isrEntryTs;
+    gap = now - rxLastTs;
+    rxLastTs = now;
+    if(gap < 2 * rxByteTs)
+    {
+      rxBackToBack++;
+      gap = (gap > rxByteTs) ? gap - rxByteTs : rxByteTs - gap;
+      if(gap > rxJitterMax)
+        rxJitterMax = gap;
+      
+      //it arrived a byte time after the last one, or no later than now;
+      //lag is only relative to the best serviced byte of the run
+      rxArrival += rxByteTs;
+      if((CPU_INT32S)(now - rxArrival) < 0)
+        rxArrival = now;
+      IsrHistAdd(isrRxLag,now - rxArrival);
+    }
+    else
+      rxArrival = now;
+    
+    //stamp a possible frame start for the latency trace
+    if(c == P1Char)
+    {
+      rxP1Ts[rxP1Put] = LatNow();
+      if(++rxP1Put == RxP1Stamps)
+        rxP1Put = 0;
+    }
+    
     //add it to put buffer
     PutBfrAddByte(&iBfrPair,c);
     
+    //wake the parser only if it is asleep; otherwise it will find
+    //the closed buffer before it sleeps
     if(PutBfrClosed(&iBfrPair))
     {
-      OSSemPost(&closedIBfrs,OS_OPT_POST_1,&osErr);
-      assert(osErr==OS_ERR_NONE);
+      rxCloses++;
+      if(rxSleeping)
+      {
+        rxSleeping = DEF_FALSE;
+        rxPosts++;
+        SignalPost(&closedIBfrs,OS_OPT_POST_NONE);
+      }
     }
     //done!
     return;
@@ -219,18 +835,23 @@ void SerialISR(void)
   //Save CPU STATUS
   CPU_SR_ALLOC();
   
-  //Disable Interrupts
-  OS_CRITICAL_ENTER();
+  isrEntryTs = CPU_TS_Get32();
+  
+  //Disable Interrupts. Not OS_CRITICAL_ENTER(): with deferred ISR
+  //posts that locks the scheduler rather than masking interrupts.
+  CPU_CRITICAL_ENTER();
   
   //Tell kernel we are in an ISR
   OSIntEnter();
   
   //Enable Interrupts
-  OS_CRITICAL_EXIT();
+  CPU_CRITICAL_EXIT();
   
   ServiceRx();
   ServiceTx();
   
+  IsrHistAdd(isrDuration,CPU_TS_Get32() - isrEntryTs);
+  
   //Tell kernel the ISR is done
   OSIntExit();
 }
\ No newline at end of file
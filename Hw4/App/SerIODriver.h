@@ -10,39 +10,148 @@ Provides input and output functions
 
 CHANGES
 02-25-2013 dwt -  Created
+10-19-2026 dwt - Output split into priority lanes
+10-19-2026 dwt - closedIBfrs moved to SerIODriver.c as a Signal
+10-19-2026 dwt - RX wakeups only when the parser sleeps, RxBfrSize
+10-19-2026 dwt - USART2 priority above IntMaskPrio
+10-19-2026 dwt - Deferred ISR posts, SerialBaud, RX jitter
+10-19-2026 dwt - RX error and backpressure accounting
+10-19-2026 dwt - RTS/CTS and XON/XOFF flow control
+10-19-2026 dwt - Occupancy counts an empty get buffer the parser holds
+10-19-2026 dwt - Latency stamps on preamble bytes and TX messages
+10-19-2026 dwt - Overruns counted as events, not bytes
 */
 #include "includes.h"
 #include "BfrPair.h"
+#include "Latency.h"
 
 // If not already defined, use the default buffer size of 4.
 #ifndef BfrSize
 #define BfrSize 4
 #endif
 
+// If not already defined, the RX buffers are the same size. Larger RX
+// buffers mean fewer buffer closes, and so fewer parser wakeups.
+#ifndef RxBfrSize
+#define RxBfrSize BfrSize
+#endif
+
+// Preamble byte stamps waiting for GetByte(): at most one per byte the
+// RX buffers hold
+#define RxP1Stamps (2*RxBfrSize)
+
 /*----- c o n s t a n t   d e f i n a t i o n s -----*/
 #define USART_TXE 0x80
 #define USART_RXNE 0x20
+#define USART_ORE 0x08      // Overrun: a byte arrived before DR was read
+#define USART_NE 0x04       // Noise detected in the byte in DR
+#define USART_FE 0x02       // Framing error in the byte in DR
 #define SuspendTimeout 0 //Timeout for semaphore wait
 
-//Semaphores
-static OS_SEM openObfrs;
-static OS_SEM closedIBfrs;
+// USART2 baud rate, also the byte time RX jitter is measured against
+#ifndef SerialBaud
+#define SerialBaud 9600
+#endif
+
+// Bits on the wire per byte: start, 8 data, stop
+#define BitsPerByte 10
+
+// SerialISR posts directly, or through the kernel's ISR handler task
+// when OS_CFG_ISR_POST_DEFERRED_EN is set in os_cfg.h. That choice is
+// kernel wide: with it, kernel critical sections lock the scheduler
+// instead of disabling interrupts, and every post made before the
+// handler task runs needs a slot in its queue (OS_CFG_INT_Q_SIZE).
+#if defined(OS_CFG_ISR_POST_DEFERRED_EN) && OS_CFG_ISR_POST_DEFERRED_EN > 0u
+#define SerialPostDeferred 1
+#else
+#define SerialPostDeferred 0
+#endif
+
+// RX flow control, asked for when the RX buffers pass RxHighWater and
+// released when they drain to RxLowWater. Occupancy counts the put
+// buffer's bytes plus the whole get buffer unless the parser is
+// waiting for the next one, since until the parser swaps it the ISR
+// can't use that space, empty or not.
+#define FlowNone 0        // Mask RX and let the USART overrun
+#define FlowRtsCts 1      // Drop RTS; TX stops while CTS is high
+#define FlowXonXoff 2     // Send XOFF and XON ahead of any output
+#ifndef RxFlow
+#define RxFlow FlowNone
+#endif
+#ifndef RxHighWater
+#define RxHighWater (2*RxBfrSize - 2)
+#endif
+#ifndef RxLowWater
+#define RxLowWater RxBfrSize
+#endif
+
+#define XON 0x11
+#define XOFF 0x13
+
+// RTS is a GPIO so it follows the watermarks; the USART's own RTSE only
+// covers the byte in DR. Active low on PD4, USART2's remapped RTS pin
+// on the eval board. A host build replaces these.
+#ifndef RtsOn
+#define RtsInit() (GPIOD->CRL = (GPIOD->CRL & ~0x000F0000) | 0x00030000)
+#define RtsOn() (GPIOD->BRR = 0x0010)     // Ready to receive
+#define RtsOff() (GPIOD->BSRR = 0x0010)   // Pause
+#endif
+#define CTSE 0x0200       // CR3: hold TX while CTS is high
+
+// USART2 interrupt priority. Must be above (less than) IntMaskPrio so
+// application critical sections never delay RX.
+#ifndef SerialPrio
+#define SerialPrio 0x00
+#endif
+
+// Output lanes. At each message boundary the lowest numbered lane with
+// a message queued is sent next.
+#define TxHigh 0      // Errors and alerts
+#define TxBulk 1      // Telemetry and reports
+#define NumTxLanes 2
+
+// If not already defined, queue up to 16 messages per lane.
+#ifndef TxMsgQSize
+#define TxMsgQSize 16
+#endif
 
 // Allocate the input buffer pair.
 static BfrPair iBfrPair;
-static CPU_INT08U iBfr0Space[BfrSize];
-static CPU_INT08U iBfr1Space[BfrSize];
+static CPU_INT08U iBfr0Space[RxBfrSize];
+static CPU_INT08U iBfr1Space[RxBfrSize];
+
+/*----- t y p e    d e f i n i t i o n s -----*/
 
-// Allocate the output buffer pair.
-static BfrPair oBfrPair;
-static CPU_INT08U oBfr0Space[BfrSize];
-static CPU_INT08U oBfr1Space[BfrSize];
+// What the RX side has lost or held off since power up
+typedef struct
+{
+  CPU_INT32U overruns;      // USART overruns, each losing 1 or more bytes
+  CPU_INT32U framing;       // Bytes received with a framing error
+  CPU_INT32U noise;         // Bytes received with noise
+  CPU_INT32U masks;         // Times a full RX buffer masked RXIE
+  CPU_INT64U maskedTs;      // Total time RXIE stayed masked, CPU_TS
+  CPU_TS maskedMax;         // Longest time RXIE stayed masked
+  CPU_INT32U pauses;        // Times flow control paused the sender
+} RxHealth;
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
 void InitSerIO(void);
 
 CPU_INT16S PutByte(CPU_INT16S txChar);
+void PutMsg(CPU_CHAR *msg);
+void PutBlock(CPU_INT08U *data,CPU_INT16U len);
+void PutLaneMsg(CPU_INT08U lane,CPU_CHAR *msg);
+void PutLaneBlock(CPU_INT08U lane,CPU_INT08U *data,CPU_INT16U len);
+void PutLaneBurst(CPU_INT08U lane,CPU_INT08U *data,
+                  CPU_INT16U *msgLens,CPU_INT08U numMsgs,
+                  LatStamps *stamps);
+void TxLaneLatency(CPU_INT08U lane,CPU_INT32U *sent,
+                   OS_TICK *avgTicks,OS_TICK *maxTicks);
 CPU_INT16S GetByte(void);
+void RxWakeups(CPU_INT32U *closes,CPU_INT32U *posts);
+void RxJitter(CPU_INT32U *bytes,CPU_TS *maxJitter);
+void RxHealthGet(RxHealth *health);
+CPU_TS RxPreambleTs(void);
 
 void ServiceTx(void);
 void ServiceRx(void);
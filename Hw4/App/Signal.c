@@ -0,0 +1,280 @@
+/*--------------- S i g n a l . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Wakeups between the RX interrupt, the parser and the payload task.
+Each has exactly one pending task, so with UseTaskSem the post goes
+straight to that task's built-in semaphore: no separate kernel object,
+no pend list to search, and a shorter post. Build with UseTaskSem 0 to
+get one OS_SEM per signal and compare.
+
+Both builds measure the cost of every post and the latency from post
+to the pending task running, in CPU_TS counts, and the report task
+sends them with the total per payload processed. The difference
+between the two builds' per payload figures is what the task
+semaphores save. A post that switches straight to the woken task is
+charged for the switch as well.
+
+The latency is taken from a time stamp each signal keeps of its first
+post the task has not yet woken for, not from the one the pend
+returns: with UseTaskSem a task's semaphore carries every signal it
+pends on, and returns the time of whichever post came last. A wake is
+charged to the task's signal posted longest ago, whichever signal the
+task pended on; further posts before that wake are folded into it.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Latency from each signal's own post time stamp
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Payload.h"
+#include "Signal.h"
+#include "assert.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define SuspendTimeout 0	    // Timeout for signal wait
+#define SigLineSize 96
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static Signal *signals[MaxSignals];          // Every signal created
+static CPU_INT08U numSignals;
+static CPU_INT16U secsLeft = SignalReportSec; // Until the next report
+static CPU_INT32U lastFrames;                 // Payloads at the last report
+static CPU_CHAR sigLine[SigLineSize];
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void SignalWoke(Signal *sig);
+
+/*--------------- S i g n a l C r e a t e ( ) ---------------*/
+
+/*
+PURPOSE
+Create a signal and add it to the report.
+
+INPUT PARAMETERS
+sig   - the signal
+name  - name for the report and the kernel object
+count - initial count, OS_SEM build only. Ignored with UseTaskSem:
+        the task semaphore starts at 0, so the task must test its
+        condition before it first pends.
+tcb   - the task that pends, task semaphore build only. The task need
+        not have been created yet.
+*/
+void SignalCreate(Signal *sig,CPU_CHAR *name,OS_SEM_CTR count,OS_TCB *tcb)
+{
+#if UseTaskSem
+  sig->tcb = tcb;
+#else
+  OS_ERR osErr;
+  
+  OSSemCreate(&sig->sem,name,count,&osErr);
+  assert(osErr==OS_ERR_NONE);
+#endif
+  sig->name = name;
+  sig->posts = 0;
+  sig->postTs = 0;
+  sig->posted = DEF_FALSE;
+  sig->wakes = 0;
+  sig->wakeTs = 0;
+  sig->wakeMax = 0;
+  
+  assert(numSignals < MaxSignals);
+  signals[numSignals++] = sig;
+}
+
+/*--------------- S i g n a l P e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Wait for a post. The caller must re-test what it was waiting for.
+
+INPUT PARAMETERS
+sig - the signal
+*/
+void SignalPend(Signal *sig)
+{
+  OS_ERR osErr;
+  
+#if UseTaskSem
+  OSTaskSemPend(SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+#else
+  OSSemPend(&sig->sem,SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+#endif
+  assert(osErr==OS_ERR_NONE);
+  
+  SignalWoke(sig);
+}
+
+/*--------------- S i g n a l A c c e p t ( ) ---------------*/
+
+/*
+PURPOSE
+Take a post if one is waiting, without blocking.
+
+INPUT PARAMETERS
+sig - the signal
+
+RETURN VALUE
+DEF_TRUE if a post was taken.
+*/
+CPU_BOOLEAN SignalAccept(Signal *sig)
+{
+  OS_ERR osErr;
+  
+#if UseTaskSem
+  OSTaskSemPend(0,OS_OPT_PEND_NON_BLOCKING,NULL,&osErr);
+#else
+  OSSemPend(&sig->sem,0,OS_OPT_PEND_NON_BLOCKING,NULL,&osErr);
+#endif
+  if(osErr != OS_ERR_NONE)
+    return DEF_FALSE;
+  
+  SignalWoke(sig);
+  return DEF_TRUE;
+}
+
+/*--------------- S i g n a l P o s t ( ) ---------------*/
+
+/*
+PURPOSE
+Wake the signal's task. May be called from an ISR.
+
+INPUT PARAMETERS
+sig - the signal
+opt - OS_OPT_POST_NONE or OS_OPT_POST_NO_SCHED
+*/
+void SignalPost(Signal *sig,OS_OPT opt)
+{
+  OS_ERR osErr;
+  CPU_TS start = CPU_TS_Get32();
+  CPU_SR_ALLOC();
+  
+  //stamp the post before it can switch to the task
+  CPU_CRITICAL_ENTER();
+  if(!sig->posted)
+  {
+    sig->postedAt = start;
+    sig->posted = DEF_TRUE;
+  }
+  CPU_CRITICAL_EXIT();
+  
+#if UseTaskSem
+  OSTaskSemPost(sig->tcb,opt,&osErr);
+#else
+  OSSemPost(&sig->sem,opt,&osErr);
+#endif
+  assert(osErr==OS_ERR_NONE);
+  
+  sig->postTs += (CPU_TS)(CPU_TS_Get32() - start);
+  sig->posts++;
+}
+
+/*--------------- S i g n a l W o k e ( ) ---------------*/
+
+/*
+PURPOSE
+Count a wakeup against the signal whose post caused it, with how long
+ago that post was made. A pend that returns for no post of the task's
+signals, such as an OS_SEM's initial count, is not counted.
+
+INPUT PARAMETERS
+sig - the signal pended on
+*/
+static void SignalWoke(Signal *sig)
+{
+  Signal *woke = NULL;
+  CPU_TS now = CPU_TS_Get32();
+  CPU_TS latency;
+#if UseTaskSem
+  CPU_INT08U i;
+#endif
+  CPU_SR_ALLOC();
+  
+  //the RX interrupt stamps its posts
+  CPU_CRITICAL_ENTER();
+#if UseTaskSem
+  //any signal of this task may have made the post
+  for(i=0;i<numSignals;i++)
+    if(signals[i]->tcb == sig->tcb && signals[i]->posted &&
+       (woke == NULL ||
+        (CPU_TS)(now - signals[i]->postedAt) > (CPU_TS)(now - woke->postedAt)))
+      woke = signals[i];
+#else
+  if(sig->posted)
+    woke = sig;
+#endif
+  if(woke != NULL)
+  {
+    woke->posted = DEF_FALSE;
+    latency = now - woke->postedAt;
+    woke->wakes++;
+    woke->wakeTs += latency;
+    if(latency > woke->wakeMax)
+      woke->wakeMax = latency;
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- S i g n a l R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. Every SignalReportSec
+seconds, send each signal's post count, average post cost and post to
+wake latency, then the cost of all of them per payload processed, and
+start a new interval.
+*/
+void SignalReport(void)
+{
+  Signal sample;
+  Signal *sig;
+  CPU_INT64U total = 0;
+  CPU_INT32U frames;
+  CPU_INT08U i;
+  CPU_SR_ALLOC();
+  
+  if(--secsLeft > 0)
+    return;
+  secsLeft = SignalReportSec;
+  
+  for(i=0;i<numSignals;i++)
+  {
+    sig = signals[i];
+    
+    //the RX interrupt posts one of these
+    CPU_CRITICAL_ENTER();
+    sample = *sig;
+    sig->posts = 0;
+    sig->postTs = 0;
+    sig->wakes = 0;
+    sig->wakeTs = 0;
+    sig->wakeMax = 0;
+    CPU_CRITICAL_EXIT();
+    
+    total += sample.postTs + sample.wakeTs;
+    sprintf(sigLine," SIGNAL %s: %lu POSTS, POST AVG %lu, WAKE AVG %lu MAX %lu TS\n",
+                    sample.name,
+                    (unsigned long) sample.posts,
+                    (unsigned long)(sample.posts ? sample.postTs / sample.posts : 0),
+                    (unsigned long)(sample.wakes ? sample.wakeTs / sample.wakes : 0),
+                    (unsigned long) sample.wakeMax);
+    PutMsg(sigLine);
+  }
+  
+  frames = PayloadFrames() - lastFrames;
+  lastFrames += frames;
+  sprintf(sigLine," SIGNAL %s: %lu TS PER PAYLOAD\n",
+                  UseTaskSem ? "TASK SEM" : "OS_SEM",
+                  (unsigned long)(frames ? total / frames : 0));
+  PutMsg(sigLine);
+}
@@ -0,0 +1,68 @@
+#ifndef __signal__
+#define __signal__
+/*--------------- S i g n a l . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Signal.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Each signal keeps the time of its first unwoken post
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Wake each consumer through its own task semaphore; 0 uses a
+// separate OS_SEM per signal
+#ifndef UseTaskSem
+#define UseTaskSem 1
+#endif
+
+// Seconds between signal reports
+#ifndef SignalReportSec
+#define SignalReportSec 60
+#endif
+
+// Most signals that can be created
+#define MaxSignals 4
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// One producer to consumer wakeup. Only one task ever pends on a
+// signal. With UseTaskSem that task's own semaphore is posted, and it
+// is shared by every signal the task pends on, so a pend may return for
+// another signal's post: callers re-test their condition after waking.
+typedef struct
+{
+#if UseTaskSem
+  OS_TCB *tcb;                  // The task that pends
+#else
+  OS_SEM sem;
+#endif
+  const CPU_CHAR *name;
+  CPU_INT32U posts;             // Posts this interval
+  CPU_INT64U postTs;            // Time spent inside the posts
+  CPU_TS postedAt;              // First post the task has not woken for
+  CPU_BOOLEAN posted;           // postedAt is set
+  CPU_INT32U wakes;             // Pends that returned for a post of
+                                // this signal this interval
+  CPU_INT64U wakeTs;            // Post to wake latency, summed
+  CPU_TS wakeMax;               // Longest post to wake latency
+} Signal;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void SignalCreate(Signal *sig,CPU_CHAR *name,OS_SEM_CTR count,OS_TCB *tcb);
+void SignalPend(Signal *sig);
+CPU_BOOLEAN SignalAccept(Signal *sig);
+void SignalPost(Signal *sig,OS_OPT opt);
+void SignalReport(void);
+
+#endif
@@ -0,0 +1,172 @@
+/*--------------- S t a t s . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Keep running statistics (count, min, max, sum, sum of squares) for every
+node and metric, and send one summary record per node each interval.
+Updates are O(1): FindNodeSlot() takes srcAddr straight to a slot.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - PayloadTask claims the node slot
+*/
+
+#include "includes.h"
+#include "Payload.h"
+#include "NodeTable.h"
+#include "SerIODriver.h"
+#include "Calendar.h"
+#include "Stats.h"
+#include "assert.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Size of one formatted summary record (header plus a line per metric)
+#define SummaryRecSize (48 + NumMetrics*80)
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_INT16U count;
+  CPU_INT32S min;
+  CPU_INT32S max;
+  CPU_INT64S sum;
+  CPU_INT64U sumSq;
+} RunStat;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static RunStat stats[NodeSlots][NumMetrics];
+static CPU_INT16U secsLeft;               // Seconds until the next summary
+static CPU_CHAR record[SummaryRecSize];   // Summary record being built
+
+/*--------------- S t a t s I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Clear every node's statistics and start a new interval.
+*/
+void StatsInit(void)
+{
+  Mem_Clr(stats,sizeof(stats));
+  secsLeft = SummarySec;
+}
+
+/*--------------- S t a t s U p d a t e ( ) ---------------*/
+
+/*
+PURPOSE
+Add a reading's fields to its node's running statistics. The node's
+slot must already have been claimed with NodeSlot().
+
+INPUT PARAMETERS
+reading - the decoded reading
+*/
+void StatsUpdate(Reading *reading)
+{
+  RunStat *stat;
+  CPU_INT08U slot;
+  CPU_INT08U metric;
+  CPU_INT08U i;
+  CPU_INT32S value;
+  
+  if(reading->numFields == 0)
+    return;
+  
+  slot = FindNodeSlot(reading->srcAddr);
+  if(slot == NoSlot)
+    return;
+  
+  for(i=0;i<reading->numFields;i++)
+  {
+    metric = MetricOf(reading->msgType,i);
+    if(metric == NoMetric)
+      continue;
+    
+    stat = &stats[slot][metric];
+    value = reading->field[i];
+    
+    if(stat->count == 0 || value < stat->min)
+      stat->min = value;
+    if(stat->count == 0 || value > stat->max)
+      stat->max = value;
+    stat->count++;
+    stat->sum += value;
+    stat->sumSq += (CPU_INT64S)value*value;
+  }
+}
+
+/*--------------- S t a t s R e p o r t ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. When the interval expires,
+send one summary record per node and start the next interval.
+*/
+void StatsReport(void)
+{
+  RunStat snap[NumMetrics];
+  CPU_CHAR *p;
+  CalDate now;
+  CPU_INT08U slot;
+  CPU_INT08U metric;
+  CPU_INT32S mean10;
+  CPU_INT32U sd10;
+  CPU_FP64 var;
+  OS_ERR osErr;
+  
+  if(--secsLeft > 0)
+    return;
+  secsLeft = SummarySec;
+  
+  for(slot=0;slot<NumNodeSlots();slot++)
+  {
+    //take this node's interval and start a fresh one without
+    //PayloadTask updating it underneath us
+    OSSchedLock(&osErr);
+    Mem_Copy(snap,stats[slot],sizeof(snap));
+    Mem_Clr(stats[slot],sizeof(snap));
+    OSSchedUnlock(&osErr);
+    
+    p = record;
+    p += sprintf(p,"\n SUMMARY NODE %d: LAST %d SECONDS",SlotAddr(slot),SummarySec);
+    if(CalClockSet())
+    {
+      CalFromEpoch(CalNow(),&now);
+      p += sprintf(p," TO %u/%u/%u %u:%02u",
+                   now.month,now.day,now.year,now.hour,now.minute);
+    }
+    p += sprintf(p,"\n");
+    
+    for(metric=0;metric<NumMetrics;metric++)
+    {
+      if(snap[metric].count == 0)
+        continue;
+      
+      //mean and standard deviation to one decimal place
+      mean10 = (CPU_INT32S)(snap[metric].sum*10/snap[metric].count);
+      var = ((CPU_FP64)snap[metric].sumSq -
+             (CPU_FP64)snap[metric].sum*snap[metric].sum/snap[metric].count) /
+            snap[metric].count;
+      sd10 = (var > 0) ? (CPU_INT32U)(sqrt(var)*10+0.5) : 0;
+      
+      p += sprintf(p,"   %s: n=%u min=%ld max=%ld mean=%s%ld.%ld sd=%lu.%lu\n",
+                   MetricName(metric),
+                   snap[metric].count,
+                   (long)snap[metric].min,
+                   (long)snap[metric].max,
+                   mean10 < 0 ? "-" : "",
+                   (long)(labs(mean10)/10),(long)(labs(mean10)%10),
+                   (unsigned long)(sd10/10),(unsigned long)(sd10%10));
+    }
+    
+    //one record per node, never split by other output
+    PutMsg(record);
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef __stats__
+#define __stats__
+/*--------------- S t a t s . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Stats.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+#include "Payload.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Summary interval in seconds
+#ifndef SummarySec
+#define SummarySec 60
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void StatsInit(void);
+void StatsUpdate(Reading *reading);
+void StatsReport(void);
+
+#endif
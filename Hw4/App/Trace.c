@@ -0,0 +1,158 @@
+/*--------------- T r a c e . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Context switch tracer. App_OS_TaskSwHook() calls TraceSwitch(), which
+stores the outgoing task, the incoming task and a free running CPU
+timestamp in a RAM ring. Tracing is switched on and off at run time,
+and a dump request has the report task send the ring as text:
+
+  TRACE <records> <timestamp Hz>
+  T <tcb> <task name>         one per task
+  S <timestamp> <from> <to>   one per switch, oldest first
+  TRACE END
+
+Tools/trace2json.py turns a captured dump into a timeline.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - TraceEnable() under IntMask()
+10-19-2026 dwt - Line buffer fits 64-bit task addresses (host build)
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Trace.h"
+#include "Intrpt.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define TraceLineSize 64
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef struct
+{
+  CPU_TS ts;          // CPU timestamp of the switch
+  OS_TCB *from;       // Task switched out
+  OS_TCB *to;         // Task switched in
+} TraceRec;
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static TraceRec traceRing[TraceSize];
+static CPU_INT32U traceNext;                 // Switches recorded, free running
+static volatile CPU_BOOLEAN traceOn = TraceOn;
+static volatile CPU_BOOLEAN dumpReq;         // Set by TraceRequestDump()
+static CPU_CHAR traceLine[TraceLineSize];
+
+/*--------------- T r a c e S w i t c h ( ) ---------------*/
+
+/*
+PURPOSE
+Record one context switch. Called from App_OS_TaskSwHook() with
+interrupts disabled, OSTCBCurPtr still the outgoing task and
+OSTCBHighRdyPtr the incoming one.
+*/
+void TraceSwitch(void)
+{
+  TraceRec *rec;
+  
+  if(!traceOn)
+    return;
+  
+  rec = &traceRing[traceNext++ & (TraceSize-1)];
+  rec->ts = CPU_TS_Get32();
+  rec->from = OSTCBCurPtr;
+  rec->to = OSTCBHighRdyPtr;
+}
+
+/*--------------- T r a c e E n a b l e ( ) ---------------*/
+
+/*
+PURPOSE
+Start or stop tracing. Starting empties the ring.
+
+INPUT PARAMETERS
+on - TRUE to trace
+*/
+void TraceEnable(CPU_BOOLEAN on)
+{
+  CPU_INT32U basepri;
+  
+  //the switch hook runs from PendSV, which IntMask() holds off
+  basepri = IntMask();
+  if(on && !traceOn)
+    traceNext = 0;
+  traceOn = on;
+  IntUnmask(basepri);
+}
+
+/*--------------- T r a c e R e q u e s t D u m p ( ) ---------------*/
+
+/*
+PURPOSE
+Ask for the ring to be sent. The dump itself is slow, so it is left to
+the report task's next pass.
+*/
+void TraceRequestDump(void)
+{
+  dumpReq = TRUE;
+}
+
+/*--------------- T r a c e P o l l ( ) ---------------*/
+
+/*
+PURPOSE
+Called once a second by the report task. If a dump was requested, stop
+tracing, send the task table and the ring, oldest switch first, then
+restart tracing with an empty ring if it was on.
+*/
+void TracePoll(void)
+{
+  CPU_ERR cpuErr;
+  CPU_BOOLEAN wasOn = traceOn;
+  CPU_INT32U numRecs;
+  CPU_INT32U i;
+  TraceRec *rec;
+  OS_TCB *tcb;
+  
+  if(!dumpReq)
+    return;
+  dumpReq = FALSE;
+  
+  //hold the ring still while it is sent
+  traceOn = FALSE;
+  numRecs = (traceNext < TraceSize) ? traceNext : TraceSize;
+  
+  sprintf(traceLine,"\nTRACE %lu %lu\n",(unsigned long) numRecs,
+                    (unsigned long) CPU_TS_TmrFreqGet(&cpuErr));
+  PutMsg(traceLine);
+  
+#if OS_CFG_DBG_EN > 0u
+  for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+  {
+    sprintf(traceLine,"T %08lx %.32s\n",(unsigned long)(CPU_ADDR) tcb,tcb->NamePtr);
+    PutMsg(traceLine);
+  }
+#endif
+  
+  for(i = traceNext - numRecs;i != traceNext;i++)
+  {
+    rec = &traceRing[i & (TraceSize-1)];
+    sprintf(traceLine,"S %lu %08lx %08lx\n",(unsigned long) rec->ts,
+                      (unsigned long)(CPU_ADDR) rec->from,
+                      (unsigned long)(CPU_ADDR) rec->to);
+    PutMsg(traceLine);
+  }
+  
+  PutMsg("TRACE END\n");
+  
+  if(wasOn)
+    TraceEnable(TRUE);
+}
@@ -0,0 +1,38 @@
+#ifndef __trace__
+#define __trace__
+/*--------------- T r a c e . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "Trace.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Context switches the ring holds; must be a power of 2
+#ifndef TraceSize
+#define TraceSize 256
+#endif
+
+// If not already defined, start with tracing off.
+#ifndef TraceOn
+#define TraceOn 0
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void TraceSwitch(void);
+void TraceEnable(CPU_BOOLEAN on);
+void TraceRequestDump(void);
+void TracePoll(void);
+
+#endif
@@ -0,0 +1,337 @@
+/*--------------- T x Q u e u e . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Decouple telemetry from the serial link. PayloadTask queues bulk
+messages here without ever blocking, and a lower priority task feeds
+them to the bulk TX lane. When the link cannot keep up, the overload
+policy decides what is given up, so the parser keeps draining its
+input and frames are never corrupted by a masked receiver. Every
+message given up is counted.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Messages keep their latency stamps
+*/
+
+#include "includes.h"
+#include "SerIODriver.h"
+#include "Payload.h"
+#include "TxQueue.h"
+#include "assert.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define SuspendTimeout 0	    // Timeout for semaphore wait
+#define TXQ_STK_SIZE 128      // TX queue task stack size
+#define TxQueuePrio 5         // TX queue task Priority
+
+// Each message is stored as a 2 byte length, its latency stamps and
+// then its bytes
+#define LenSize 2
+#define StampSize sizeof(LatStamps)
+
+// Bytes and messages the task takes from the queue per transfer
+#define SendBfrSize 512
+#define SendMsgs 16
+
+//----- g l o b a l    v a r i a b l e s -----
+
+static  OS_TCB   txqTCB;                       // TX queue task TCB
+static  CPU_STK  txqStk[TXQ_STK_SIZE];         // Space for TX queue task stack
+
+static CPU_INT08U qBfr[TxQSize];    // Queued messages, oldest at qHead
+static CPU_INT16U qHead;            // Index of the oldest message
+static CPU_INT16U qUsed;            // Bytes queued
+
+static CPU_INT08U policy = ShedPolicy;
+static CPU_BOOLEAN summarizing;     // ShedSummary currently engaged
+
+static CPU_INT32U shedOldest;       // Queued messages discarded
+static CPU_INT32U shedNew;          // New messages refused
+static CPU_INT32U shedReadings;     // Readings left to the summaries
+
+static CPU_INT08U sendBfr[SendBfrSize];    // Messages being sent
+static CPU_INT16U sendLens[SendMsgs];      // Their lengths
+static LatStamps sendStamps[SendMsgs];     // Their stamps
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void QPut(CPU_INT08U *src,CPU_INT16U len);
+static void QGet(CPU_INT08U *dst,CPU_INT16U len);
+static CPU_INT16U QPeekLen(void);
+static CPU_INT08U TakeMsgs(void);
+
+/*--------------- T x Q u e u e I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Empty the queue and create the TX queue task.
+*/
+void TxQueueInit(void)
+{
+  OS_ERR osErr;
+  
+  qHead = 0;
+  qUsed = 0;
+  summarizing = FALSE;
+  
+  //create TX queue task
+  OSTaskCreate(&txqTCB,                // Task Control Block
+               "TX Queue Task",        // Task name
+               TxQueueTask,            // Task entry point
+               NULL,                   // Address of optional task data block
+               TxQueuePrio,            // Task priority
+               &txqStk[0],             // Base address of task stack space
+               TXQ_STK_SIZE / 10,      // Stack water mark limit
+               TXQ_STK_SIZE,           // Task stack size
+               0,                      // This task has no task queue
+               0,                      // Number of clock ticks (defaults to 10)
+               NULL,                   // Pointer to TCB extension
+               (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   // Task options
+               &osErr);
+  assert(osErr==OS_ERR_NONE);
+}
+
+/*--------------- T x Q u e u e T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Wait for queued messages and send them on the bulk lane, as many at a
+time as fit in the send buffer. This task is the only one that blocks
+on the bulk lane for telemetry.
+*/
+void TxQueueTask(void *data)
+{
+  OS_ERR osErr;
+  CPU_INT08U numMsgs;
+  
+  for(;;)
+  {
+    OSTaskSemPend(SuspendTimeout,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+    assert(osErr==OS_ERR_NONE);
+    
+    while((numMsgs = TakeMsgs()) > 0)
+      PutLaneBurst(TxBulk,sendBfr,sendLens,numMsgs,sendStamps);
+  }
+}
+
+/*--------------- T x Q u e u e P u t ( ) ---------------*/
+
+/*
+PURPOSE
+Queue one telemetry message without blocking. If it does not fit, the
+overload policy applies: ShedDropOldest discards queued messages until
+it does, the other policies discard the new message.
+
+INPUT PARAMETERS
+msg    - the message bytes
+len    - the number of bytes
+stamps - the latency stamps of the packet it was rendered from
+*/
+void TxQueuePut(CPU_INT08U *msg,CPU_INT16U len,LatStamps *stamps)
+{
+  OS_ERR osErr;
+  CPU_INT08U lenBytes[LenSize];
+  
+  if(len==0)
+    return;
+  
+  //too big to ever be sent
+  if(len > SendBfrSize)
+  {
+    shedNew++;
+    return;
+  }
+  
+  //the TX queue task takes messages out from under us
+  OSSchedLock(&osErr);
+  
+  if(policy == ShedDropOldest)
+    while(qUsed > 0 && qUsed + LenSize + StampSize + len > TxQSize)
+    {
+      QGet(NULL,LenSize + StampSize + QPeekLen());
+      shedOldest++;
+    }
+  
+  if(qUsed + LenSize + StampSize + len > TxQSize)
+  {
+    shedNew++;
+    OSSchedUnlock(&osErr);
+    return;
+  }
+  
+  lenBytes[0] = len >> ByteSize;
+  lenBytes[1] = len & ByteMask;
+  QPut(lenBytes,LenSize);
+  QPut((CPU_INT08U *) stamps,StampSize);
+  QPut(msg,len);
+  
+  OSSchedUnlock(&osErr);
+  
+  OSTaskSemPost(&txqTCB,OS_OPT_POST_NONE,&osErr);
+  assert(osErr==OS_ERR_NONE);
+}
+
+/*--------------- T x Q u e u e S u m m a r y O n l y ( ) ---------------*/
+
+/*
+PURPOSE
+Under ShedSummary, tell whether readings should be left to the periodic
+summaries because the queue is backed up. Engages above TxQHighWater
+and releases below TxQLowWater; each reading shed is counted.
+
+RETURN VALUE
+TRUE if the caller should not send the reading, otherwise FALSE
+*/
+CPU_BOOLEAN TxQueueSummaryOnly(void)
+{
+  if(policy != ShedSummary)
+    return FALSE;
+  
+  if(qUsed >= TxQHighWater)
+    summarizing = TRUE;
+  else if(qUsed <= TxQLowWater)
+    summarizing = FALSE;
+  
+  if(summarizing)
+    shedReadings++;
+  
+  return summarizing;
+}
+
+/*--------------- S e t S h e d P o l i c y ( ) ---------------*/
+
+/*
+PURPOSE
+Select the overload policy. Called by RunCommand() for CmdShedPolicy.
+
+INPUT PARAMETERS
+newPolicy - ShedDropOldest, ShedDropNew or ShedSummary
+*/
+void SetShedPolicy(CPU_INT08U newPolicy)
+{
+  policy = newPolicy;
+  summarizing = FALSE;
+}
+
+/*--------------- T x Q u e u e D r o p s ( ) ---------------*/
+
+/*
+PURPOSE
+Report what the overload policy has given up since power up.
+
+INPUT PARAMETERS
+oldest     - returns the number of queued messages discarded
+newest     - returns the number of new messages refused
+summarized - returns the number of readings left to the summaries
+*/
+void TxQueueDrops(CPU_INT32U *oldest,CPU_INT32U *newest,
+                  CPU_INT32U *summarized)
+{
+  *oldest = shedOldest;
+  *newest = shedNew;
+  *summarized = shedReadings;
+}
+
+/*--------------- T a k e M s g s ( ) ---------------*/
+
+/*
+PURPOSE
+Move as many whole messages as fit from the queue into sendBfr.
+
+RETURN VALUE
+The number of messages taken; their lengths are in sendLens and their
+stamps in sendStamps.
+*/
+static CPU_INT08U TakeMsgs(void)
+{
+  OS_ERR osErr;
+  CPU_INT08U numMsgs = 0;
+  CPU_INT16U sendLen = 0;
+  CPU_INT16U len;
+  
+  OSSchedLock(&osErr);
+  
+  while(qUsed > 0 && numMsgs < SendMsgs)
+  {
+    len = QPeekLen();
+    if(sendLen + len > SendBfrSize)
+      break;
+    
+    QGet(NULL,LenSize);
+    QGet((CPU_INT08U *) &sendStamps[numMsgs],StampSize);
+    QGet(&sendBfr[sendLen],len);
+    sendLens[numMsgs++] = len;
+    sendLen += len;
+  }
+  
+  OSSchedUnlock(&osErr);
+  
+  return numMsgs;
+}
+
+/*--------------- Q P u t ( ) ---------------*/
+
+/*
+PURPOSE
+Append bytes at the tail of the queue, wrapping as needed. The caller
+has checked that they fit.
+
+INPUT PARAMETERS
+src - the bytes
+len - the number of bytes
+*/
+static void QPut(CPU_INT08U *src,CPU_INT16U len)
+{
+  CPU_INT16U tail = (qHead + qUsed) % TxQSize;
+  
+  qUsed += len;
+  while(len-- > 0)
+  {
+    qBfr[tail] = *src++;
+    if(++tail == TxQSize)
+      tail = 0;
+  }
+}
+
+/*--------------- Q G e t ( ) ---------------*/
+
+/*
+PURPOSE
+Remove bytes from the head of the queue.
+
+INPUT PARAMETERS
+dst - where to copy them, or NULL to discard them
+len - the number of bytes
+*/
+static void QGet(CPU_INT08U *dst,CPU_INT16U len)
+{
+  qUsed -= len;
+  while(len-- > 0)
+  {
+    if(dst != NULL)
+      *dst++ = qBfr[qHead];
+    if(++qHead == TxQSize)
+      qHead = 0;
+  }
+}
+
+/*--------------- Q P e e k L e n ( ) ---------------*/
+
+/*
+PURPOSE
+Read the length of the oldest message without removing it.
+
+RETURN VALUE
+The message length in bytes, not counting its length field.
+*/
+static CPU_INT16U QPeekLen(void)
+{
+  return (qBfr[qHead] << ByteSize) | qBfr[(qHead + 1) % TxQSize];
+}
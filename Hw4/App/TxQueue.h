@@ -0,0 +1,54 @@
+#ifndef __txqueue__
+#define __txqueue__
+/*--------------- T x Q u e u e . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+This header file defines the public names (functions and types)
+exported from the module "TxQueue.c"
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Messages keep their latency stamps
+10-19-2026 dwt - CmdShedPolicy sets the policy at run time
+*/
+#include "includes.h"
+#include "Latency.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// Overload policies: what TxQueuePut() does when the queue is full
+#define ShedDropOldest 0    // Discard the oldest queued telemetry
+#define ShedDropNew 1       // Discard the new message
+#define ShedSummary 2       // Fall back to summary-only output
+
+// If not already defined, drop the oldest telemetry first. CmdShedPolicy
+// changes the policy at run time.
+#ifndef ShedPolicy
+#define ShedPolicy ShedDropOldest
+#endif
+
+// Size of the telemetry queue in bytes
+#ifndef TxQSize
+#define TxQSize 2048
+#endif
+
+// ShedSummary engages above the high water mark and releases below the low
+#define TxQHighWater (TxQSize*3/4)
+#define TxQLowWater (TxQSize/4)
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void TxQueueInit(void);
+void TxQueueTask(void *data);
+void TxQueuePut(CPU_INT08U *msg,CPU_INT16U len,LatStamps *stamps);
+CPU_BOOLEAN TxQueueSummaryOnly(void);
+void SetShedPolicy(CPU_INT08U newPolicy);
+void TxQueueDrops(CPU_INT32U *oldest,CPU_INT32U *newest,
+                  CPU_INT32U *summarized);
+
+#endif
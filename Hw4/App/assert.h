@@ -24,4 +24,4 @@ cond  - a Boolean which if false indicates a failed assertion
 */
 #define assert(cond) \
 if(!(cond)) \
-  asm(" BKPT 0xFF");
\ No newline at end of file
+  asm(" BKPT 0xFF");
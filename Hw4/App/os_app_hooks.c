@@ -29,6 +29,9 @@
 
 #include <os.h>
 #include <os_app_hooks.h>
+#include "Monitor.h"
+#include "Trace.h"
+#include "Idle.h"
 
 /*$PAGE*/
 /*
@@ -161,7 +164,7 @@ void  App_OS_TaskReturnHook (OS_TCB  *p_tcb)
 
 void  App_OS_IdleTaskHook (void)
 {
-
+    IdleSleep();                                        /* Sleep until the next interrupt, account the time        */
 }
 
 /*$PAGE*/
@@ -180,7 +183,7 @@ void  App_OS_IdleTaskHook (void)
 
 void  App_OS_StatTaskHook (void)
 {
-
+    MonitorSample();                                    /* Per-task CPU, context switch and stack samples          */
 }
 
 /*$PAGE*/
@@ -202,7 +205,7 @@ void  App_OS_StatTaskHook (void)
 
 void  App_OS_TaskSwHook (void)
 {
-
+    TraceSwitch();                                      /* Context switch tracer                                   */
 }
 
 /*$PAGE*/
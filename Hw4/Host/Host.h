@@ -0,0 +1,109 @@
+#ifndef __host__
+#define __host__
+/*--------------- H o s t . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Names shared by the modules of the host build: the CPU model
+(HostCPU.c), the kernel shim (HostOS.c), the simulated USART2
+(HostUart.c) and the command line and summary (HostMain.c).
+
+The host runs one task at a time, like the target. Interrupts are
+taken only at the points where the target could first take them after
+being held off: a critical section ending, BASEPRI dropping, the end
+of a kernel call, and wfi. A pending interrupt is serviced on the
+running task's thread, and may switch tasks through OSIntExit().
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the kernel's time keeping figures
+10-19-2026 dwt - Added HostIntDisCount()
+*/
+#include <stdio.h>
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define NsPerSec 1000000000ULL
+#define NsPerMs 1000000ULL
+#define NsPerUs 1000ULL
+
+#define HostClkFreq 72000000u   // BSP_CPU_ClkFreq(), sets the SysTick reload
+#define HostTickPrio 0xF0       // SysTick priority, OS_CPU_SysTickInit()'s
+
+#define HostTaskStkSize (256 * 1024)  // pthread stack for every task
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// What the simulated sender and receiver saw
+typedef struct
+{
+  CPU_INT64U offered;       // Bytes sent to RX
+  CPU_INT64U delivered;     // ... read from DR by ServiceRx()
+  CPU_INT64U lost;          // ... overwritten before they were read
+  CPU_INT64U sent;          // Bytes written to DR by ServiceTx()
+  CPU_INT32U pauses;        // Times RTS or XOFF paused the sender
+  CPU_INT64U firstNs;       // First byte offered
+  CPU_INT64U lastNs;        // Last byte delivered or sent
+} HostUartStats;
+
+// How the kernel kept time against the target's, the host's less its
+// stalls
+typedef struct
+{
+  OS_TICK ticks;            // OSTickCtr
+  CPU_INT64U ticksNs;       // Target time since SysTick started
+  CPU_INT64U stolenNs;      // Host stalls left out of it
+  CPU_INT32U delays;        // OSTimeDly() calls that slept
+  CPU_INT64S dlyEarlyNs;    // Most any ended before dly-1 ticks
+  CPU_INT64S dlyLateNs;     // ... or after dly ticks
+  CPU_INT32U periods;       // Periodic timer periods timed
+  CPU_INT64S tmrOffNs;      // Most any period was off by
+} HostTimeStats;
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+extern CPU_BOOLEAN hostKernel;     // The running task is in the shim
+extern CPU_BOOLEAN hostIsr;        // ... or in an interrupt handler
+extern CPU_SR hostPrimask;
+extern CPU_INT32U hostBasepri;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+// HostCPU.c
+CPU_INT64U HostNow(void);
+void HostCpuInit(void);
+void HostIntWindow(void);
+CPU_BOOLEAN HostIntTaken(void);
+void HostWfi(void);
+void HostIsrExit(void);
+void HostIntDisCount(CPU_TS_TMR t);
+CPU_INT64U HostTargetNs(void);
+CPU_INT64U HostTickNs(void);
+CPU_INT64U HostStolenNs(void);
+void HostFatal(const char *what);
+
+// HostOS.c
+CPU_INT64U HostTaskCpuNs(OS_TCB *tcb);
+void HostTimeGet(HostTimeStats *time);
+
+// HostUart.c
+void HostUartOpen(const char *path,CPU_INT32U repeat,CPU_INT64U gapNs,
+                  CPU_BOOLEAN lossless,CPU_INT64U txNs,FILE *out);
+CPU_BOOLEAN HostUartPoll(CPU_INT64U now,CPU_BOOLEAN arrive);
+CPU_INT64U HostUartNextEvent(CPU_INT64U now);
+void HostUartWait(CPU_INT64U until);
+void HostUartIsr(void);
+void HostUartIsrDone(void);
+CPU_BOOLEAN HostUartDone(CPU_INT64U now,CPU_INT64U quietNs);
+void HostUartStatsGet(HostUartStats *stats);
+
+// HostMain.c
+void HostIdleDone(void);
+
+#endif
@@ -0,0 +1,792 @@
+/*--------------- H o s t C P U . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+The host's model of the Cortex-M3 and the eval board: PRIMASK and
+BASEPRI, SysTick, the NVIC bits the application touches, uC/CPU's
+timestamp and interrupts disabled measurement, and the BSP calls.
+
+CPU_TS counts nanoseconds of CLOCK_MONOTONIC, truncated to 32 bits.
+SysTick counts down at HostClkFreq once OS_CPU_SysTickInit() has run,
+firing and reloading from SYST_RVR as it passes 0. The host only looks
+at SysTick at kernel calls, critical section exits and wfi, so every
+pass through 0 is owed its interrupt; unlike on the target, no tick is
+lost to interrupts held off too long. Stopping it, writing SYST_CVR
+and changing SYST_RVR behave as on the target, so Idle.c can stretch a
+tick period. Every SysTick register is reached through a function
+that first takes in the application's writes since the last access,
+as made at that access, then brings the counter up to the present;
+SYST_RVR's skips the second step, as a reload written straight after
+a restart must not see the host's time between the two.
+
+SysTick runs on the target's time, which is the host's less its
+stalls. A virtual machine can leave the process unrun for tens of
+milliseconds, which the target never sees; a gap of more than StallNs
+between two looks at SysTick is counted as StallNs, as if a debugger
+had halted the target for the rest.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - SysTick counts from SYST_RVR and honours SYST_CVR and
+                 SYST_CSR writes, on the target's time
+10-19-2026 dwt - Kernel calls count toward the interrupts disabled time
+*/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "Host.h"
+#include "Idle.h"
+#include "SerIODriver.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+// The System Control Space page: SETENA1 and IPR38 land in it
+#define ScsBase 0xE000E000UL
+#define ScsSize 0x1000UL
+#define HostSetena1 (*((volatile CPU_INT32U *) 0xE000E104))
+#define HostIpr38 (*((volatile CPU_INT08U *) 0xE000E426))
+#define Usart2Ena 0x00000040
+
+// Longest host sleep in wfi. A virtual machine may oversleep a long
+// one by tens of milliseconds, so wfi wakes to poll at least this often.
+#define WfiSliceNs NsPerMs
+
+// Longest gap between looks at SysTick taken as the target's time
+#define StallNs (2 * WfiSliceNs)
+
+// SysTick counts to host time and back
+#define CountsNs(counts) ((CPU_INT64U) (counts) * NsPerSec / HostClkFreq)
+#define NsCounts(ns) ((CPU_INT64U) (ns) * HostClkFreq / NsPerSec)
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+CPU_BOOLEAN hostKernel;
+CPU_BOOLEAN hostIsr;
+CPU_SR hostPrimask;
+CPU_INT32U hostBasepri;
+
+static volatile CPU_INT32U systCsr; // SYST_CSR as the application sees it
+static volatile CPU_INT32U systRvr; // SYST_RVR
+static volatile CPU_INT32U systCvr; // SYST_CVR as last read
+static CPU_INT32U csrSeen;          // systCsr as last handed out
+static CPU_INT32U cvrSeen;          // systCvr ...
+static CPU_BOOLEAN systOn;          // SysTick counting
+static CPU_BOOLEAN countFlag;       // COUNTFLAG, cleared by reading CSR
+static CPU_INT32U systHeld;         // The count while stopped
+static CPU_INT64U zeroNs;           // When a running count next reaches 0
+static CPU_INT64U systNs;           // When SysTick was last brought up
+static CPU_INT64U startNs;          // When OS_CPU_SysTickInit() ran
+static CPU_INT64U stolenNs;         // Host stalls left out of target time
+static CPU_INT64U lastNs;           // Host time of the last look
+static CPU_INT32U ticksPending;     // Passes through 0 not yet taken
+static CPU_BOOLEAN usartPending;    // USART2 interrupt line
+static CPU_INT32U taken;            // Interrupts taken
+
+static CPU_TS intDisTs;             // When PRIMASK was last set
+static CPU_TS_TMR intDisMax;        // Longest PRIMASK time ever
+static CPU_TS_TMR intDisMaxCur;     // ... since the last reset
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void Poll(CPU_BOOLEAN arrive);
+static CPU_INT64U Target(CPU_INT64U now);
+static void SystSync(CPU_INT64U now);
+static void SystTake(void);
+static void SystStart(CPU_INT64U now);
+static CPU_INT32U SystCount(CPU_INT64U now);
+static void IntDisStart(void);
+static void IntDisEnd(void);
+static void TickISR(void);
+
+/*--------------- H o s t N o w ( ) ---------------*/
+
+/*
+PURPOSE
+Read the host's monotonic clock.
+
+RETURN VALUE
+Nanoseconds since an arbitrary start
+*/
+CPU_INT64U HostNow(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return (CPU_INT64U) ts.tv_sec * NsPerSec + ts.tv_nsec;
+}
+
+/*--------------- H o s t F a t a l ( ) ---------------*/
+
+/*
+PURPOSE
+Report a failure of the host itself, as opposed to the application,
+and stop.
+
+INPUT PARAMETERS
+what - what failed
+*/
+void HostFatal(const char *what)
+{
+  fflush(stdout);
+  fprintf(stderr,"host: %s\n",what);
+  exit(2);
+}
+
+/*--------------- H o s t C p u I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Back the System Control Space page with memory, so the application's
+NVIC writes (interrupt enables and priorities) land somewhere the
+host can read them. Must run before the application's main().
+*/
+void HostCpuInit(void)
+{
+  void *scs;
+
+  scs = mmap((void *) ScsBase,ScsSize,PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,-1,0);
+  if(scs != (void *) ScsBase)
+    HostFatal("can't map the System Control Space page");
+}
+
+/*--------------- H o s t A s m ( ) ---------------*/
+
+/*
+PURPOSE
+Carry out one of the application's inline assembly statements.
+
+INPUT PARAMETERS
+instr - the instruction, as written in the source
+file  - source file it is in
+line  - ... and line
+*/
+void HostAsm(const char *instr,const char *file,int line)
+{
+  //as on the target, only CPU_CRITICAL sections are measured
+  if(strstr(instr,"cpsid") != NULL)
+    hostPrimask = 1;
+  else if(strstr(instr,"cpsie") != NULL)
+  {
+    hostPrimask = 0;
+    HostIntWindow();
+  }
+  else if(strstr(instr,"wfi") != NULL)
+    HostWfi();
+  else if(strstr(instr,"BKPT") != NULL)
+  {
+    fflush(stdout);
+    fprintf(stderr,"%s:%d: assertion failed\n",file,line);
+    abort();
+  }
+  else
+  {
+    fprintf(stderr,"%s:%d: no host version of \"%s\"\n",file,line,instr);
+    abort();
+  }
+}
+
+/*--------------- H o s t G e t B a s e p r i ( ) ---------------*/
+
+/*
+PURPOSE
+Read BASEPRI.
+
+RETURN VALUE
+The current BASEPRI, 0 if nothing is masked by priority
+*/
+uint32_t HostGetBasepri(void)
+{
+  return hostBasepri;
+}
+
+/*--------------- H o s t S e t B a s e p r i ( ) ---------------*/
+
+/*
+PURPOSE
+Write BASEPRI, taking any interrupt the new value unmasks.
+
+INPUT PARAMETERS
+basepri - the new BASEPRI
+*/
+void HostSetBasepri(uint32_t basepri)
+{
+  CPU_INT32U old = hostBasepri;
+
+  hostBasepri = basepri;
+  if(basepri == 0 || (old != 0 && basepri > old))
+    HostIntWindow();
+}
+
+/*--------------- H o s t S y s t C s r ( ) ---------------*/
+
+/*
+PURPOSE
+SYST_CSR: ENABLE starts and stops the count, and COUNTFLAG tells if it
+passed 0 since the last access, which clears it.
+
+RETURN VALUE
+The register
+*/
+volatile uint32_t *HostSystCsr(void)
+{
+  SystSync(HostTargetNs());
+  systCsr = (systCsr & ~SYST_COUNTFLAG) | (countFlag ? SYST_COUNTFLAG : 0);
+  countFlag = DEF_FALSE;
+  csrSeen = systCsr;
+
+  return &systCsr;
+}
+
+/*--------------- H o s t S y s t R v r ( ) ---------------*/
+
+/*
+PURPOSE
+SYST_RVR: the count reloaded on passing 0. A write takes effect at
+the next reload.
+
+RETURN VALUE
+The register
+*/
+volatile uint32_t *HostSystRvr(void)
+{
+  SystTake();
+
+  return &systRvr;
+}
+
+/*--------------- H o s t S y s t C v r ( ) ---------------*/
+
+/*
+PURPOSE
+SYST_CVR: the count, down from SYST_RVR to 0 through each period. A
+write clears it, and COUNTFLAG, so the next count reloads.
+
+RETURN VALUE
+The register
+*/
+volatile uint32_t *HostSystCvr(void)
+{
+  SystSync(HostTargetNs());
+  systCvr = SystCount(systNs);
+  cvrSeen = systCvr;
+
+  return &systCvr;
+}
+
+/*--------------- H o s t I c s r ( ) ---------------*/
+
+/*
+PURPOSE
+SCB_ICSR: just PENDSTSET, for a SysTick not yet taken.
+
+RETURN VALUE
+The register
+*/
+volatile uint32_t *HostIcsr(void)
+{
+  static volatile CPU_INT32U icsr;
+
+  Poll(DEF_FALSE);
+  icsr = (ticksPending > 0) ? PENDSTSET : 0;
+
+  return &icsr;
+}
+
+/*--------------- H o s t I s p r 1 ( ) ---------------*/
+
+/*
+PURPOSE
+NVIC_ISPR1: just USART2PEND, for a USART2 interrupt not yet taken.
+
+RETURN VALUE
+The register
+*/
+volatile uint32_t *HostIspr1(void)
+{
+  static volatile CPU_INT32U ispr1;
+
+  Poll(DEF_FALSE);
+  ispr1 = usartPending ? USART2PEND : 0;
+
+  return &ispr1;
+}
+
+/*--------------- H o s t I n t W i n d o w ( ) ---------------*/
+
+/*
+PURPOSE
+Take every pending interrupt that PRIMASK and BASEPRI let in, USART2
+first as its priority is higher. Does nothing inside the shim or an
+interrupt handler, so handlers never nest.
+*/
+void HostIntWindow(void)
+{
+  if(hostPrimask || hostKernel || hostIsr)
+    return;
+
+  Poll(DEF_TRUE);
+  for(;;)
+  {
+    if(usartPending && (HostSetena1 & Usart2Ena) &&
+       !(hostBasepri != 0 && HostIpr38 >= hostBasepri))
+    {
+      hostIsr = DEF_TRUE;
+      taken++;
+      HostUartIsr();
+    }
+    else if(ticksPending > 0 &&
+            !(hostBasepri != 0 && HostTickPrio >= hostBasepri))
+    {
+      ticksPending--;
+      hostIsr = DEF_TRUE;
+      taken++;
+      TickISR();
+    }
+    else
+      break;
+
+    //OSIntExit() ended the handler; a task switch may have come between
+    Poll(DEF_FALSE);
+    if(hostPrimask || hostKernel || hostIsr)
+      break;
+  }
+}
+
+/*--------------- H o s t I n t T a k e n ( ) ---------------*/
+
+/*
+PURPOSE
+Tell whether any interrupt was taken since the last call. The idle
+task waits for one itself if its hook didn't.
+
+RETURN VALUE
+TRUE if an interrupt was taken
+*/
+CPU_BOOLEAN HostIntTaken(void)
+{
+  static CPU_INT32U seen;
+  CPU_BOOLEAN any = (taken != seen);
+
+  seen = taken;
+
+  return any;
+}
+
+/*--------------- H o s t W f i ( ) ---------------*/
+
+/*
+PURPOSE
+Wait for an interrupt to be pending, whether or not PRIMASK lets it
+in yet, as wfi does, polling at least every WfiSliceNs.
+*/
+void HostWfi(void)
+{
+  CPU_INT64U now;
+  CPU_INT64U until;
+
+  for(;;)
+  {
+    Poll(DEF_TRUE);
+    if(ticksPending > 0 || usartPending)
+      return;
+
+    now = HostNow();
+    until = HostUartNextEvent(now);
+    if(systOn && zeroNs + stolenNs < until)
+      until = zeroNs + stolenNs;
+    if(until > now + WfiSliceNs)
+      until = now + WfiSliceNs;
+    HostUartWait(until);
+  }
+}
+
+/*--------------- H o s t I s r E x i t ( ) ---------------*/
+
+/*
+PURPOSE
+Finish the interrupt being handled. Called by OSIntExit() before it
+switches tasks, so the next task sees the device as the handler left
+it.
+*/
+void HostIsrExit(void)
+{
+  HostUartIsrDone();
+  hostIsr = DEF_FALSE;
+}
+
+/*--------------- P o l l ( ) ---------------*/
+
+/*
+PURPOSE
+Bring SysTick and USART2 up to the present.
+
+INPUT PARAMETERS
+arrive - TRUE if a back to back RX byte may arrive now
+*/
+static void Poll(CPU_BOOLEAN arrive)
+{
+  CPU_INT64U now = HostNow();
+
+  SystSync(Target(now));
+  usartPending = HostUartPoll(now,arrive);
+}
+
+/*--------------- H o s t T a r g e t N s ( ) ---------------*/
+
+/*
+PURPOSE
+Read the target's time. Called only by the running task.
+
+RETURN VALUE
+HostNow() less the host's stalls
+*/
+CPU_INT64U HostTargetNs(void)
+{
+  return Target(HostNow());
+}
+
+/*--------------- H o s t T i c k N s ( ) ---------------*/
+
+/*
+RETURN VALUE
+Target time since OS_CPU_SysTickInit(), 0 before it
+*/
+CPU_INT64U HostTickNs(void)
+{
+  return (startNs != 0) ? HostTargetNs() - startNs : 0;
+}
+
+/*--------------- H o s t S t o l e n N s ( ) ---------------*/
+
+/*
+RETURN VALUE
+Host stalls left out of the target's time
+*/
+CPU_INT64U HostStolenNs(void)
+{
+  return stolenNs;
+}
+
+/*--------------- T a r g e t ( ) ---------------*/
+
+/*
+PURPOSE
+Turn a host time into the target's, taking out any stall since the
+last look.
+
+INPUT PARAMETERS
+now - HostNow()
+
+RETURN VALUE
+The target's time
+*/
+static CPU_INT64U Target(CPU_INT64U now)
+{
+  if(lastNs != 0 && now - lastNs > StallNs)
+    stolenNs += now - lastNs - StallNs;
+  lastNs = now;
+
+  return now - stolenNs;
+}
+
+/*--------------- S y s t S y n c ( ) ---------------*/
+
+/*
+PURPOSE
+Bring SysTick up to the present. The application's writes since the
+last access are taken first; then the counter runs to now, firing at
+each pass through 0. SysTick times are all the target's.
+
+INPUT PARAMETERS
+now - the target's time
+*/
+static void SystSync(CPU_INT64U now)
+{
+  CPU_INT64U period;
+  CPU_INT64U passes;
+
+  SystTake();
+  if(systOn && now >= zeroNs)
+  {
+    countFlag = DEF_TRUE;
+    period = CountsNs(systRvr + 1);
+    passes = (now - zeroNs) / period + 1;
+    ticksPending += (CPU_INT32U) passes;
+    zeroNs += passes * period;
+  }
+  systNs = now;
+}
+
+/*--------------- S y s t T a k e ( ) ---------------*/
+
+/*
+PURPOSE
+Take the application's writes to SYST_CVR and SYST_CSR since the last
+access, as made at that access.
+*/
+static void SystTake(void)
+{
+  if(systCvr != cvrSeen)
+  {
+    cvrSeen = systCvr;
+    countFlag = DEF_FALSE;
+    systHeld = 0;
+    if(systOn)
+      SystStart(systNs);
+  }
+
+  if((systCsr ^ csrSeen) & SYST_ENABLE)
+  {
+    csrSeen = systCsr;
+    if(systCsr & SYST_ENABLE)
+      SystStart(systNs);
+    else
+    {
+      systHeld = SystCount(systNs);
+      systOn = DEF_FALSE;
+    }
+  }
+}
+
+/*--------------- S y s t S t a r t ( ) ---------------*/
+
+/*
+PURPOSE
+Run the counter from the count held. From 0, the first count reloads
+SYST_RVR.
+
+INPUT PARAMETERS
+now - when it starts
+*/
+static void SystStart(CPU_INT64U now)
+{
+  systOn = DEF_TRUE;
+  zeroNs = now + CountsNs((systHeld != 0) ? systHeld : systRvr + 1);
+}
+
+/*--------------- S y s t C o u n t ( ) ---------------*/
+
+/*
+PURPOSE
+Read the counter.
+
+INPUT PARAMETERS
+now - the target's time, no earlier than the last SystSync()
+
+RETURN VALUE
+The count, no more than SYST_RVR
+*/
+static CPU_INT32U SystCount(CPU_INT64U now)
+{
+  CPU_INT64U count;
+
+  if(!systOn)
+    return systHeld;
+
+  count = NsCounts(zeroNs - now);
+
+  return (count > systRvr) ? systRvr : (CPU_INT32U) count;
+}
+
+/*--------------- T i c k I S R ( ) ---------------*/
+
+/*
+PURPOSE
+The SysTick handler, OS_CPU_SysTickHandler()'s host version.
+*/
+static void TickISR(void)
+{
+  CPU_SR_ALLOC();
+
+  CPU_CRITICAL_ENTER();
+  OSIntEnter();
+  CPU_CRITICAL_EXIT();
+
+  OSTimeTick();
+
+  OSIntExit();
+}
+
+/*--------------- I n t D i s S t a r t ( ) ---------------*/
+
+/*
+PURPOSE
+PRIMASK was just set by CPU_CRITICAL_ENTER(): start timing it, on the
+target's time.
+*/
+static void IntDisStart(void)
+{
+  intDisTs = (CPU_TS) HostTargetNs();
+}
+
+/*--------------- I n t D i s E n d ( ) ---------------*/
+
+/*
+PURPOSE
+PRIMASK is about to clear: record how long it was set.
+*/
+static void IntDisEnd(void)
+{
+  HostIntDisCount((CPU_TS) HostTargetNs() - intDisTs);
+}
+
+/*--------------- H o s t I n t D i s C o u n t ( ) ---------------*/
+
+/*
+PURPOSE
+Count a time interrupts were disabled, PRIMASK's or the kernel's, into
+uC/CPU's interrupts disabled measurement.
+
+INPUT PARAMETERS
+t - how long, target nanoseconds
+*/
+void HostIntDisCount(CPU_TS_TMR t)
+{
+  if(t > intDisMaxCur)
+    intDisMaxCur = t;
+  if(t > intDisMax)
+    intDisMax = t;
+}
+
+/*--------------- C P U _ I n i t ( ) ---------------*/
+
+void CPU_Init(void)
+{
+  intDisMax = 0;
+  intDisMaxCur = 0;
+}
+
+/*--------------- C P U _ S R _ S a v e ( ) ---------------*/
+
+CPU_SR CPU_SR_Save(void)
+{
+  CPU_SR sr = hostPrimask;
+
+  if(!sr)
+  {
+    hostPrimask = 1;
+    IntDisStart();
+  }
+
+  return sr;
+}
+
+/*--------------- C P U _ S R _ R e s t o r e ( ) ---------------*/
+
+void CPU_SR_Restore(CPU_SR cpu_sr)
+{
+  if(hostPrimask && !cpu_sr)
+  {
+    IntDisEnd();
+    hostPrimask = 0;
+    HostIntWindow();
+  }
+}
+
+/*--------------- C P U _ T S _ G e t 3 2 ( ) ---------------*/
+
+CPU_TS CPU_TS_Get32(void)
+{
+  return (CPU_TS) HostNow();
+}
+
+/*--------------- C P U _ T S _ T m r F r e q G e t ( ) ---------------*/
+
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err)
+{
+  *p_err = CPU_ERR_NONE;
+
+  return (CPU_TS_TMR_FREQ) NsPerSec;
+}
+
+/*--------------- C P U _ I n t D i s M e a s M a x C u r R e s e t ( ) ---------------*/
+
+CPU_TS_TMR CPU_IntDisMeasMaxCurReset(void)
+{
+  CPU_TS_TMR t = intDisMaxCur;
+
+  intDisMaxCur = 0;
+
+  return t;
+}
+
+/*--------------- C P U _ I n t D i s M e a s M a x C u r G e t ( ) ---------------*/
+
+CPU_TS_TMR CPU_IntDisMeasMaxCurGet(void)
+{
+  return intDisMaxCur;
+}
+
+/*--------------- C P U _ I n t D i s M e a s M a x G e t ( ) ---------------*/
+
+CPU_TS_TMR CPU_IntDisMeasMaxGet(void)
+{
+  return intDisMax;
+}
+
+/*--------------- C P U _ C n t L e a d Z e r o s ( ) ---------------*/
+
+CPU_DATA CPU_CntLeadZeros(CPU_DATA val)
+{
+  return (val == 0) ? 32 : (CPU_DATA) __builtin_clz(val);
+}
+
+/*--------------- O S _ C P U _ S y s T i c k I n i t ( ) ---------------*/
+
+/*
+PURPOSE
+Start SysTick with a reload of cnts CPU clocks.
+
+INPUT PARAMETERS
+cnts - CPU clocks per tick
+*/
+void OS_CPU_SysTickInit(CPU_INT32U cnts)
+{
+  startNs = HostTargetNs();
+  SystSync(startNs);
+
+  systRvr = cnts - 1;
+  systHeld = 0;
+  systCsr |= SYST_ENABLE;
+  csrSeen = systCsr;
+  SystStart(startNs);
+}
+
+/*--------------- B S P ---------------*/
+
+void BSP_Init(void)
+{
+}
+
+void BSP_IntDisAll(void)
+{
+}
+
+CPU_INT32U BSP_CPU_ClkFreq(void)
+{
+  return HostClkFreq;
+}
+
+void BSP_Ser_Init(CPU_INT32U baud_rate)
+{
+  (void) baud_rate;
+}
+
+void BSP_Ser_Printf(CPU_CHAR *format,...)
+{
+  va_list args;
+
+  va_start(args,format);
+  vfprintf(stderr,format,args);
+  va_end(args);
+}
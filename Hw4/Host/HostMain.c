@@ -0,0 +1,346 @@
+/*--------------- H o s t M a i n . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Command line and end of run summary of the host build. Prog4.c's
+main() is built as AppMain().
+
+USAGE
+  gateway [-g usec] [-l] [-t usec] [-r count] [-q msec] [-c] [-k]
+          [-w pct] [file]
+
+  file      bytes for USART2 RX, default stdin; TX goes to stdout
+  -g usec   RX gap between bytes; 0 (default) sends back to back, as
+            fast as interrupts can be taken
+  -l        lossless: hold each RX byte until the last was read, even
+            while RXIE is masked
+  -t usec   TX time per byte; 0 (default) takes each byte at once
+  -r count  send the file count times
+  -q msec   quiet time after the input that ends the run, default 200
+  -c        check: exit with status 1 if any RX byte was lost
+  -k        check the kernel's time keeping: exit with status 1 if
+            OSTickCtr drifted more than TickSlack ticks from the
+            target's time, the host's less its stalls, or a delay
+            ended more than TimeSlackNs outside its dly-1 to dly
+            ticks, or a timer period was off by more than that
+  -w pct    exit with status 1 if more than pct percent of the RX
+            buffers closed had to post the parser awake
+
+The summary goes to stderr: bytes in and out, payloads per second and
+per PayloadTask wakeup, RX buffers closed and the parser posts they
+needed, what each task cost per payload in CPU and context switches,
+how long packets took through each stage of the gateway, how ISR posts
+were made, the longest interrupts were disabled, the RX jitter, and
+how the kernel kept time.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Report what the TX queue shed
+10-19-2026 dwt - Report packet latency by stage
+10-19-2026 dwt - Report suppressed readings by type
+10-19-2026 dwt - Report payloads per wakeup and switches per payload
+10-19-2026 dwt - Report and check the kernel's time keeping
+10-19-2026 dwt - Report and check the parser posts per RX buffer
+10-19-2026 dwt - Report ISR posts, interrupts disabled time and RX jitter
+10-19-2026 dwt - Report readings with no node slot or no history
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Host.h"
+#include "Payload.h"
+#include "SerIODriver.h"
+#include "TxQueue.h"
+#include "NodeTable.h"
+#include "History.h"
+#include "Latency.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define QuietMs 200       // Default quiet time that ends a run
+#define TickSlack 2       // Ticks OSTickCtr may be off, -k
+
+// How far a delay or timer period may be off, -k: a tick, and a host
+// gap just short of a stall (HostCPU.c) at either end
+#define TimeSlackNs (5 * NsPerMs)
+
+#define TickNs (NsPerSec / OS_CFG_TICK_RATE_HZ)
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+static CPU_INT64U quietNs = QuietMs * NsPerMs;
+static CPU_BOOLEAN check;
+static CPU_BOOLEAN timeCheck;
+static CPU_BOOLEAN wakeCheck;
+static CPU_INT32U wakePct;      // Posts allowed per 100 closes, -w
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+CPU_INT32S AppMain(void);
+static void Usage(void);
+static void Summary(void);
+static CPU_BOOLEAN TimeKept(void);
+static CPU_BOOLEAN WakesFew(void);
+
+/*--------------- m a i n ( ) ---------------*/
+
+int main(int argc,char *argv[])
+{
+  CPU_INT64U gapNs = 0;
+  CPU_INT64U txNs = 0;
+  CPU_BOOLEAN lossless = DEF_FALSE;
+  CPU_INT32U repeat = 1;
+  int opt;
+
+  while((opt = getopt(argc,argv,"g:lt:r:q:ckw:")) != -1)
+    switch(opt)
+    {
+    case 'g':
+      gapNs = strtoull(optarg,NULL,10) * NsPerUs;
+      break;
+    case 'l':
+      lossless = DEF_TRUE;
+      break;
+    case 't':
+      txNs = strtoull(optarg,NULL,10) * NsPerUs;
+      break;
+    case 'r':
+      repeat = strtoul(optarg,NULL,10);
+      break;
+    case 'q':
+      quietNs = strtoull(optarg,NULL,10) * NsPerMs;
+      break;
+    case 'c':
+      check = DEF_TRUE;
+      break;
+    case 'k':
+      timeCheck = DEF_TRUE;
+      break;
+    case 'w':
+      wakeCheck = DEF_TRUE;
+      wakePct = strtoul(optarg,NULL,10);
+      break;
+    default:
+      Usage();
+    }
+  if(argc - optind > 1)
+    Usage();
+
+  HostCpuInit();
+  HostUartOpen((optind < argc) ? argv[optind] : NULL,repeat,gapNs,
+               lossless,txNs,stdout);
+
+  return AppMain();
+}
+
+/*--------------- H o s t I d l e D o n e ( ) ---------------*/
+
+/*
+PURPOSE
+End the run once the input is all handled. Called from the idle task,
+so nothing else is ready.
+*/
+void HostIdleDone(void)
+{
+  HostUartStats stats;
+
+  if(!HostUartDone(HostNow(),quietNs))
+    return;
+
+  fflush(stdout);
+  Summary();
+
+  HostUartStatsGet(&stats);
+  if(check && stats.lost > 0)
+    exit(1);
+  if(wakeCheck && !WakesFew())
+    exit(1);
+  exit((timeCheck && !TimeKept()) ? 1 : 0);
+}
+
+/*--------------- U s a g e ( ) ---------------*/
+
+static void Usage(void)
+{
+  fprintf(stderr,"usage: gateway [-g usec] [-l] [-t usec] [-r count] "
+                 "[-q msec] [-c] [-k] [-w pct] [file]\n");
+  exit(2);
+}
+
+/*--------------- S u m m a r y ( ) ---------------*/
+
+/*
+PURPOSE
+Send the end of run figures to stderr. The run lasts from the first
+RX byte to the last byte read or sent.
+*/
+static void Summary(void)
+{
+  HostUartStats stats;
+  RxHealth health;
+  HostTimeStats time;
+  OS_TCB *tcb;
+  CPU_INT32U frames = PayloadFrames();
+  CPU_INT32U sent;
+  CPU_INT32U oldest;
+  CPU_INT32U newest;
+  CPU_INT32U summarized;
+  CPU_INT32U closes;
+  CPU_INT32U posts;
+  CPU_INT32U bytes;
+  CPU_TS jitter;
+  OS_TICK avgTicks;
+  OS_TICK maxTicks;
+  CPU_INT08U lane;
+  CPU_INT08U stage;
+  CPU_INT32U count;
+  CPU_TS avg;
+  CPU_TS max;
+  CPU_FP64 usPerTs = 1.0e6 / LatencyFreq();
+  CPU_FP64 secs;
+  CPU_FP64 ms;
+
+  HostUartStatsGet(&stats);
+  RxHealthGet(&health);
+  secs = (stats.lastNs > stats.firstNs) ?
+         (CPU_FP64) (stats.lastNs - stats.firstNs) / NsPerSec : 0.0;
+
+  fprintf(stderr,"\nHOST RX: %llu offered, %llu read, %llu lost, "
+                 "%lu pauses\n",
+          (unsigned long long) stats.offered,
+          (unsigned long long) stats.delivered,
+          (unsigned long long) stats.lost,(unsigned long) stats.pauses);
+  TxQueueDrops(&oldest,&newest,&summarized);
+  fprintf(stderr,"HOST TX: %llu bytes, shed %lu oldest %lu new "
+                 "%lu summarized\n",(unsigned long long) stats.sent,
+          (unsigned long) oldest,(unsigned long) newest,
+          (unsigned long) summarized);
+  fprintf(stderr,"HOST SUPPRESSED: %lu temp, %lu baro, %lu hum, %lu wind, "
+                 "%lu rad, %lu time, %lu precip\n",
+          (unsigned long) NodeTableSuppressed(TempMsg),
+          (unsigned long) NodeTableSuppressed(BaroMsg),
+          (unsigned long) NodeTableSuppressed(HumMsg),
+          (unsigned long) NodeTableSuppressed(WindMsg),
+          (unsigned long) NodeTableSuppressed(RadMsg),
+          (unsigned long) NodeTableSuppressed(TimeMsg),
+          (unsigned long) NodeTableSuppressed(PrecipMsg));
+  fprintf(stderr,"HOST NODE SLOTS: %u of %u used, %lu readings with none, "
+                 "%lu not in history\n",
+          (unsigned) NumNodeSlots(),(unsigned) NodeSlots,
+          (unsigned long) NodeSlotsFull(),
+          (unsigned long) HistoryUnrecorded());
+  fprintf(stderr,"HOST PAYLOADS: %lu in %.3f s, %.0f/s, %.0f RX bytes/s\n",
+          (unsigned long) frames,secs,
+          (secs > 0.0) ? frames / secs : 0.0,
+          (secs > 0.0) ? stats.delivered / secs : 0.0);
+  fprintf(stderr,"HOST WAKEUPS: %lu, %.2f payloads per wakeup\n",
+          (unsigned long) PayloadWakeups(),
+          (PayloadWakeups() > 0) ? (CPU_FP64) frames / PayloadWakeups() : 0.0);
+  fprintf(stderr,"HOST RX HEALTH: %lu overruns, %lu masks, %lu pauses\n",
+          (unsigned long) health.overruns,(unsigned long) health.masks,
+          (unsigned long) health.pauses);
+  RxWakeups(&closes,&posts);
+  fprintf(stderr,"HOST RX WAKE: %lu buffers closed, %lu posted the parser\n",
+          (unsigned long) closes,(unsigned long) posts);
+
+  fprintf(stderr,"HOST TASK                 CPU ms   us/payload  switches"
+                 "  sw/payload\n");
+  for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+  {
+    ms = (CPU_FP64) HostTaskCpuNs(tcb) / NsPerMs;
+    fprintf(stderr,"  %-22.22s %9.3f %12.3f %9lu %11.2f\n",tcb->NamePtr,ms,
+            (frames > 0) ? ms * 1000.0 / frames : 0.0,
+            (unsigned long) tcb->CtxSwCtr,
+            (frames > 0) ? (CPU_FP64) tcb->CtxSwCtr / frames : 0.0);
+  }
+
+  for(lane = 0;lane < NumTxLanes;lane++)
+  {
+    TxLaneLatency(lane,&sent,&avgTicks,&maxTicks);
+    fprintf(stderr,"HOST TX LANE %u: %lu msgs, wait avg %lu max %lu ticks\n",
+            (unsigned) lane,(unsigned long) sent,(unsigned long) avgTicks,
+            (unsigned long) maxTicks);
+  }
+
+  for(stage = 0;stage < NumLatStages;stage++)
+  {
+    LatencyGet(stage,&count,&avg,&max);
+    fprintf(stderr,"HOST LATENCY %s: %lu msgs, avg %.1f max %.1f us\n",
+            LatencyName(stage),(unsigned long) count,avg * usPerTs,
+            max * usPerTs);
+  }
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+  fprintf(stderr,"HOST ISR POSTS: deferred, queue at most %u of %u, "
+                 "%u lost\n",(unsigned) OSIntQNbrEntriesMax,
+          (unsigned) OS_CFG_INT_Q_SIZE,(unsigned) OSIntQOvfCtr);
+#else
+  fprintf(stderr,"HOST ISR POSTS: direct\n");
+#endif
+  fprintf(stderr,"HOST INT DIS: at most %.1f us\n",
+          CPU_IntDisMeasMaxGet() * usPerTs);
+  RxJitter(&bytes,&jitter);
+  fprintf(stderr,"HOST RX JITTER: %lu back to back bytes, at most %.1f us "
+                 "off the byte time\n",(unsigned long) bytes,jitter * usPerTs);
+
+  HostTimeGet(&time);
+  fprintf(stderr,"HOST TICKS: %lu in %.3f s, %+lld from target time, "
+                 "%.3f s of host stalls left out\n",
+          (unsigned long) time.ticks,(CPU_FP64) time.ticksNs / NsPerSec,
+          (long long) time.ticks - (long long) (time.ticksNs / TickNs),
+          (CPU_FP64) time.stolenNs / NsPerSec);
+  fprintf(stderr,"HOST DELAYS: %lu, at most %.1f us early %.1f us late\n",
+          (unsigned long) time.delays,(CPU_FP64) time.dlyEarlyNs / NsPerUs,
+          (CPU_FP64) time.dlyLateNs / NsPerUs);
+  fprintf(stderr,"HOST TIMERS: %lu periods, at most %.1f us off\n",
+          (unsigned long) time.periods,(CPU_FP64) time.tmrOffNs / NsPerUs);
+}
+
+/*--------------- T i m e K e p t ( ) ---------------*/
+
+/*
+PURPOSE
+Check the kernel's time keeping against the target's time, for -k.
+
+RETURN VALUE
+TRUE if the tick count was within TickSlack ticks, and every delay
+and timer period within TimeSlackNs
+*/
+static CPU_BOOLEAN TimeKept(void)
+{
+  HostTimeStats time;
+  CPU_INT64S drift;
+
+  HostTimeGet(&time);
+  drift = (CPU_INT64S) time.ticks - (CPU_INT64S) (time.ticksNs / TickNs);
+
+  return drift >= -TickSlack && drift <= TickSlack &&
+         time.dlyEarlyNs <= (CPU_INT64S) TimeSlackNs &&
+         time.dlyLateNs <= (CPU_INT64S) TimeSlackNs &&
+         time.tmrOffNs <= (CPU_INT64S) TimeSlackNs;
+}
+
+/*--------------- W a k e s F e w ( ) ---------------*/
+
+/*
+PURPOSE
+Check the parser posts against the RX buffers closed, for -w.
+
+RETURN VALUE
+TRUE if no more than wakePct percent of the closes posted the parser
+*/
+static CPU_BOOLEAN WakesFew(void)
+{
+  CPU_INT32U closes;
+  CPU_INT32U posts;
+
+  RxWakeups(&closes,&posts);
+
+  return (CPU_INT64U) posts * 100 <= (CPU_INT64U) closes * wakePct;
+}
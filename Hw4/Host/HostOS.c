@@ -0,0 +1,1332 @@
+/*--------------- H o s t O S . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+The uC/OS-III API on pthreads, for the host build.
+
+Every task gets a thread, but only the task in OSTCBCurPtr runs. A
+switch hands OSTCBCurPtr to the new task, signals its condition
+variable and waits on its own, so the kernel's rules decide who runs:
+the highest priority ready task, preempting at once, with tasks of
+equal priority run in the order they became ready. hostLock is held
+for the length of every kernel call.
+
+Differences from the target kernel:
+- Pend lists are found by scanning the tasks; there are few.
+- OSTimeTick() updates the tick wheel itself; there is no tick task.
+- A mutex owner inherits a waiter's priority only while it holds that
+  one mutex.
+- OSTaskDel() only deletes the calling task.
+- OSTaskStkChk() reports the whole stack free; task stacks are the
+  threads'.
+- Task CPU usage is each thread's CPU time, so kernel and interrupt
+  time is charged to the task it happened on.
+- With OS_CFG_ISR_POST_DEFERRED_EN set, only semaphore posts go through
+  the ISR handler task; OSTimeTick() still does its own work.
+- No interrupt is taken inside a kernel call, deferred posts or not.
+  Kernel calls count toward uC/CPU's interrupts disabled time, as on
+  the target, unless ISR posts are deferred, when the target kernel
+  only locks the scheduler for them.
+
+The shim also times the kernel against the target's time, the host's
+less its stalls (HostCPU.c): how far each OSTimeDly() ran from the
+ticks it asked for, and how far each periodic timer's callbacks fell
+from its period. HostTimeGet() reports them.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Delays and timeouts on a tick wheel, timer task on
+                 OSTmrUpdateCtr, and the kernel timed against the target
+10-19-2026 dwt - Deferred ISR posts through the ISR handler task
+*/
+
+#include <time.h>
+
+#include "Host.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define TickNs ((CPU_INT64S) (NsPerSec / OS_CFG_TICK_RATE_HZ))
+
+// Ticks between timer task runs
+#define TmrUpdateCnt (OS_CFG_TICK_RATE_HZ / OS_CFG_TMR_TASK_RATE_HZ)
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+// A semaphore post an interrupt handler left to the ISR handler task
+typedef struct
+{
+  void *obj;                        // The semaphore, as pends name it
+  OS_SEM_CTR *ctr;                  // Its count
+  CPU_TS *objTs;                    // When it was last posted
+  OS_OPT opt;
+  CPU_TS ts;                        // When the handler posted
+} IntQEntry;
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+OS_TCB *OSTCBCurPtr;
+OS_TCB *OSTCBHighRdyPtr;
+OS_TCB *OSTaskDbgListPtr;
+OS_NESTING_CTR OSIntNestingCtr;
+OS_NESTING_CTR OSSchedLockNestingCtr;
+OS_CTX_SW_CTR OSTaskCtxSwCtr;
+OS_TICK OSTickCtr;
+OS_CTR OSTmrUpdateCtr;
+OS_CPU_USAGE OSStatTaskCPUUsage;
+CPU_BOOLEAN OSRunning;
+
+OS_TCB OSIdleTaskTCB;
+OS_TCB OSStatTaskTCB;
+OS_TCB OSTmrTaskTCB;
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+OS_TCB OSIntQTaskTCB;
+OS_OBJ_QTY OSIntQNbrEntries;
+OS_OBJ_QTY OSIntQNbrEntriesMax;
+OS_OBJ_QTY OSIntQOvfCtr;
+#endif
+
+const OS_TICK OSCfg_TickRate_Hz = OS_CFG_TICK_RATE_HZ;
+OS_TICK_SPOKE OSCfg_TickWheel[OS_CFG_TICK_WHEEL_SIZE];
+const OS_OBJ_QTY OSCfg_TickWheelSize = OS_CFG_TICK_WHEEL_SIZE;
+
+OS_APP_HOOK_TCB OS_AppTaskCreateHookPtr;
+OS_APP_HOOK_TCB OS_AppTaskDelHookPtr;
+OS_APP_HOOK_TCB OS_AppTaskReturnHookPtr;
+OS_APP_HOOK_VOID OS_AppIdleTaskHookPtr;
+OS_APP_HOOK_VOID OS_AppStatTaskHookPtr;
+OS_APP_HOOK_VOID OS_AppTaskSwHookPtr;
+OS_APP_HOOK_VOID OS_AppTimeTickHookPtr;
+
+static pthread_mutex_t hostLock = PTHREAD_MUTEX_INITIALIZER;
+static CPU_INT32U seq;              // Orders readies and pends
+static OS_TMR *tmrList;             // Every timer created
+static CPU_TS kernelTs;             // When this kernel section began,
+                                    // target time
+
+static CPU_INT32U delays;           // OSTimeDly() calls that slept
+static CPU_INT64S dlyEarlyNs;       // Most any ended short of its ticks
+static CPU_INT64S dlyLateNs;        // ... or past them
+static CPU_INT32U periods;          // Periodic timer periods timed
+static CPU_INT64S tmrOffNs;         // Most any period was off by
+
+static CPU_STK idleStk[OS_CFG_IDLE_TASK_STK_SIZE];
+static CPU_STK statStk[OS_CFG_STAT_TASK_STK_SIZE];
+static CPU_STK tmrStk[OS_CFG_TMR_TASK_STK_SIZE];
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+static IntQEntry intQ[OS_CFG_INT_Q_SIZE];
+static OS_OBJ_QTY intQIn;           // Next entry to fill
+static OS_OBJ_QTY intQOut;          // ... and to post
+static CPU_STK intQStk[OS_CFG_INT_Q_TASK_STK_SIZE];
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void Lock(void);
+static void Unlock(void);
+static void Leave(void);
+static void KernelOut(void);
+static void WaitTurn(OS_TCB *tcb);
+static OS_TCB *Highest(void);
+static void Sched(void);
+static void Switch(OS_TCB *next);
+static void Ready(OS_TCB *tcb,OS_ERR err,CPU_TS ts);
+static void TickInsert(OS_TCB *tcb,OS_TICK ticks);
+static void TickRemove(OS_TCB *tcb);
+static void Pend(void *obj,OS_TICK timeout);
+static OS_TCB *Waiter(void *obj);
+static OS_SEM_CTR CtrPend(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,
+                          OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                          OS_ERR *p_err);
+static OS_SEM_CTR CtrPost(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,
+                          OS_OPT opt,CPU_TS ts);
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+static void IntQPost(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,OS_OPT opt,
+                     OS_ERR *p_err);
+static void IntQTask(void *p_arg);
+#endif
+static void *TaskThread(void *arg);
+static void IdleTask(void *p_arg);
+static void StatTask(void *p_arg);
+static void TmrTask(void *p_arg);
+
+/*--------------- O S I n i t ( ) ---------------*/
+
+void OSInit(OS_ERR *p_err)
+{
+  OSRunning = DEF_FALSE;
+  OSTmrUpdateCtr = TmrUpdateCnt;
+
+  OSTaskCreate(&OSIdleTaskTCB,"uC/OS-III Idle Task",IdleTask,NULL,
+               OS_CFG_PRIO_MAX - 1u,idleStk,0,OS_CFG_IDLE_TASK_STK_SIZE,
+               0,0,NULL,OS_OPT_TASK_NONE,p_err);
+  if(*p_err != OS_ERR_NONE)
+    return;
+
+  OSTaskCreate(&OSStatTaskTCB,"uC/OS-III Stat Task",StatTask,NULL,
+               OS_CFG_STAT_TASK_PRIO,statStk,0,OS_CFG_STAT_TASK_STK_SIZE,
+               0,0,NULL,OS_OPT_TASK_NONE,p_err);
+  if(*p_err != OS_ERR_NONE)
+    return;
+
+  OSTaskCreate(&OSTmrTaskTCB,"uC/OS-III Timer Task",TmrTask,NULL,
+               OS_CFG_TMR_TASK_PRIO,tmrStk,0,OS_CFG_TMR_TASK_STK_SIZE,
+               0,0,NULL,OS_OPT_TASK_NONE,p_err);
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+  if(*p_err != OS_ERR_NONE)
+    return;
+
+  OSTaskCreate(&OSIntQTaskTCB,"uC/OS-III ISR Queue Task",IntQTask,NULL,
+               0u,intQStk,0,OS_CFG_INT_Q_TASK_STK_SIZE,
+               0,0,NULL,OS_OPT_TASK_NONE,p_err);
+#endif
+}
+
+/*--------------- O S S t a r t ( ) ---------------*/
+
+/*
+PURPOSE
+Run the highest priority task. The calling thread is not a task, so
+it leaves the process to the tasks.
+*/
+void OSStart(OS_ERR *p_err)
+{
+  Lock();
+  OSRunning = DEF_TRUE;
+  OSTCBHighRdyPtr = Highest();
+  OSTCBCurPtr = OSTCBHighRdyPtr;
+  OSTCBCurPtr->CtxSwCtr++;
+  pthread_cond_signal(&OSTCBCurPtr->HostRun);
+  Unlock();
+
+  *p_err = OS_ERR_NONE;
+  pthread_exit(NULL);
+}
+
+/*--------------- O S S c h e d ( ) ---------------*/
+
+void OSSched(void)
+{
+  Lock();
+  Sched();
+  Leave();
+}
+
+/*--------------- O S S c h e d L o c k ( ) ---------------*/
+
+void OSSchedLock(OS_ERR *p_err)
+{
+  OSSchedLockNestingCtr++;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S S c h e d U n l o c k ( ) ---------------*/
+
+void OSSchedUnlock(OS_ERR *p_err)
+{
+  *p_err = OS_ERR_NONE;
+  if(OSSchedLockNestingCtr == 0)
+    return;
+
+  Lock();
+  if(--OSSchedLockNestingCtr == 0)
+    Sched();
+  Leave();
+}
+
+/*--------------- O S I n t E n t e r ( ) ---------------*/
+
+void OSIntEnter(void)
+{
+  if(OSRunning)
+    OSIntNestingCtr++;
+}
+
+/*--------------- O S I n t E x i t ( ) ---------------*/
+
+/*
+PURPOSE
+End an interrupt handler: finish the device's side of it, then switch
+to the highest priority ready task. The interrupted task resumes here
+when it next runs.
+*/
+void OSIntExit(void)
+{
+  Lock();
+  if(OSIntNestingCtr > 0)
+    OSIntNestingCtr--;
+  if(OSIntNestingCtr == 0)
+  {
+    HostIsrExit();
+    Sched();
+  }
+  Unlock();
+}
+
+/*--------------- O S T a s k C r e a t e ( ) ---------------*/
+
+void OSTaskCreate(OS_TCB *p_tcb,CPU_CHAR *p_name,OS_TASK_PTR p_task,
+                  void *p_arg,OS_PRIO prio,CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit,CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size,OS_TICK time_quanta,void *p_ext,
+                  OS_OPT opt,OS_ERR *p_err)
+{
+  pthread_attr_t attr;
+  int err;
+
+  (void) stk_limit;
+  (void) q_size;
+  (void) time_quanta;
+  (void) p_ext;
+
+  if(opt & OS_OPT_TASK_STK_CLR)
+    Mem_Clr(p_stk_base,stk_size * sizeof(CPU_STK));
+
+  Mem_Clr(p_tcb,sizeof(OS_TCB));
+  p_tcb->NamePtr = p_name;
+  p_tcb->StkBasePtr = p_stk_base;
+  p_tcb->StkSize = stk_size;
+  p_tcb->Prio = prio;
+  p_tcb->BasePrio = prio;
+  p_tcb->TaskState = OS_TASK_STATE_RDY;
+  p_tcb->HostEntry = p_task;
+  p_tcb->HostArg = p_arg;
+  pthread_cond_init(&p_tcb->HostRun,NULL);
+
+  Lock();
+  p_tcb->HostSeq = ++seq;
+  p_tcb->DbgNextPtr = OSTaskDbgListPtr;
+  if(OSTaskDbgListPtr != NULL)
+    OSTaskDbgListPtr->DbgPrevPtr = p_tcb;
+  OSTaskDbgListPtr = p_tcb;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr,HostTaskStkSize);
+  err = pthread_create(&p_tcb->HostThread,&attr,TaskThread,p_tcb);
+  pthread_attr_destroy(&attr);
+  if(err != 0)
+    HostFatal("can't create a task thread");
+  Unlock();
+
+  if(OS_AppTaskCreateHookPtr != NULL)
+    OS_AppTaskCreateHookPtr(p_tcb);
+
+  *p_err = OS_ERR_NONE;
+
+  //the new task may outrank the creator
+  if(OSRunning)
+  {
+    Lock();
+    Sched();
+    Leave();
+  }
+}
+
+/*--------------- O S T a s k D e l ( ) ---------------*/
+
+/*
+PURPOSE
+Delete the calling task; its thread ends.
+*/
+void OSTaskDel(OS_TCB *p_tcb,OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+
+  if(p_tcb != NULL && p_tcb != self)
+  {
+    *p_err = OS_ERR_TASK_DEL_INVALID;
+    return;
+  }
+
+  if(OS_AppTaskDelHookPtr != NULL)
+    OS_AppTaskDelHookPtr(self);
+
+  Lock();
+  if(self->DbgPrevPtr != NULL)
+    self->DbgPrevPtr->DbgNextPtr = self->DbgNextPtr;
+  else
+    OSTaskDbgListPtr = self->DbgNextPtr;
+  if(self->DbgNextPtr != NULL)
+    self->DbgNextPtr->DbgPrevPtr = self->DbgPrevPtr;
+
+  self->TaskState = OS_TASK_STATE_DEL;
+  Sched();
+  Unlock();
+
+  pthread_exit(NULL);
+}
+
+/*--------------- O S T a s k S e m P e n d ( ) ---------------*/
+
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                         OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+
+  return CtrPend(&self->SemCtr,&self->SemCtr,&self->TS,
+                 timeout,opt,p_ts,p_err);
+}
+
+/*--------------- O S T a s k S e m P o s t ( ) ---------------*/
+
+OS_SEM_CTR OSTaskSemPost(OS_TCB *p_tcb,OS_OPT opt,OS_ERR *p_err)
+{
+  if(p_tcb == NULL)
+    p_tcb = OSTCBCurPtr;
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+  if(OSIntNestingCtr > 0)
+  {
+    IntQPost(&p_tcb->SemCtr,&p_tcb->SemCtr,&p_tcb->TS,opt,p_err);
+    return 0;
+  }
+#endif
+  *p_err = OS_ERR_NONE;
+
+  return CtrPost(&p_tcb->SemCtr,&p_tcb->SemCtr,&p_tcb->TS,opt,
+                 CPU_TS_Get32());
+}
+
+/*--------------- O S T a s k S t k C h k ( ) ---------------*/
+
+void OSTaskStkChk(OS_TCB *p_tcb,CPU_STK_SIZE *p_free,CPU_STK_SIZE *p_used,
+                  OS_ERR *p_err)
+{
+  if(p_tcb == NULL)
+    p_tcb = OSTCBCurPtr;
+
+  *p_free = p_tcb->StkSize;
+  *p_used = 0;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S S e m C r e a t e ( ) ---------------*/
+
+void OSSemCreate(OS_SEM *p_sem,CPU_CHAR *p_name,OS_SEM_CTR cnt,
+                 OS_ERR *p_err)
+{
+  p_sem->NamePtr = p_name;
+  p_sem->Ctr = cnt;
+  p_sem->TS = 0;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S S e m P e n d ( ) ---------------*/
+
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem,OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                     OS_ERR *p_err)
+{
+  return CtrPend(p_sem,&p_sem->Ctr,&p_sem->TS,timeout,opt,p_ts,p_err);
+}
+
+/*--------------- O S S e m P o s t ( ) ---------------*/
+
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem,OS_OPT opt,OS_ERR *p_err)
+{
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+  if(OSIntNestingCtr > 0)
+  {
+    IntQPost(p_sem,&p_sem->Ctr,&p_sem->TS,opt,p_err);
+    return 0;
+  }
+#endif
+  *p_err = OS_ERR_NONE;
+
+  return CtrPost(p_sem,&p_sem->Ctr,&p_sem->TS,opt,CPU_TS_Get32());
+}
+
+/*--------------- O S M u t e x C r e a t e ( ) ---------------*/
+
+void OSMutexCreate(OS_MUTEX *p_mutex,CPU_CHAR *p_name,OS_ERR *p_err)
+{
+  p_mutex->NamePtr = p_name;
+  p_mutex->OwnerTCBPtr = NULL;
+  p_mutex->OwnerNestingCtr = 0;
+  p_mutex->TS = 0;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S M u t e x P e n d ( ) ---------------*/
+
+void OSMutexPend(OS_MUTEX *p_mutex,OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                 OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+  OS_TCB *owner;
+
+  Lock();
+  owner = p_mutex->OwnerTCBPtr;
+  if(owner == NULL)
+  {
+    p_mutex->OwnerTCBPtr = self;
+    p_mutex->OwnerNestingCtr = 1;
+    *p_err = OS_ERR_NONE;
+  }
+  else if(owner == self)
+  {
+    p_mutex->OwnerNestingCtr++;
+    *p_err = OS_ERR_MUTEX_OWNER;
+  }
+  else if(opt & OS_OPT_PEND_NON_BLOCKING)
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+  else
+  {
+    //the owner runs at our priority until it lets go
+    if(owner->Prio > self->Prio)
+      owner->Prio = self->Prio;
+    Pend(p_mutex,timeout);
+    *p_err = self->HostPendErr;
+  }
+  if(p_ts != NULL)
+    *p_ts = p_mutex->TS;
+  Leave();
+}
+
+/*--------------- O S M u t e x P o s t ( ) ---------------*/
+
+void OSMutexPost(OS_MUTEX *p_mutex,OS_OPT opt,OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+  OS_TCB *next;
+
+  Lock();
+  if(p_mutex->OwnerTCBPtr != self)
+    *p_err = OS_ERR_MUTEX_NOT_OWNER;
+  else if(--p_mutex->OwnerNestingCtr > 0)
+    *p_err = OS_ERR_MUTEX_OWNER;
+  else
+  {
+    *p_err = OS_ERR_NONE;
+    self->Prio = self->BasePrio;
+    p_mutex->TS = CPU_TS_Get32();
+
+    next = Waiter(p_mutex);
+    p_mutex->OwnerTCBPtr = next;
+    if(next != NULL)
+    {
+      p_mutex->OwnerNestingCtr = 1;
+      Ready(next,OS_ERR_NONE,p_mutex->TS);
+    }
+    if(!(opt & OS_OPT_POST_NO_SCHED))
+      Sched();
+  }
+  Leave();
+}
+
+/*--------------- O S T i m e G e t ( ) ---------------*/
+
+OS_TICK OSTimeGet(OS_ERR *p_err)
+{
+  *p_err = OS_ERR_NONE;
+
+  return OSTickCtr;
+}
+
+/*--------------- O S T i m e D l y ( ) ---------------*/
+
+/*
+PURPOSE
+Delay for dly ticks, and time the delay: it should end after dly-1
+whole tick periods and before dly have passed.
+*/
+void OSTimeDly(OS_TICK dly,OS_OPT opt,OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+  CPU_INT64U start;
+  CPU_INT64S took;
+
+  (void) opt;
+  *p_err = OS_ERR_NONE;
+  if(dly == 0)
+    return;
+
+  start = HostTargetNs();
+  Lock();
+  self->TaskState = OS_TASK_STATE_DLY;
+  TickInsert(self,dly);
+  Sched();
+
+  took = (CPU_INT64S) (HostTargetNs() - start);
+  delays++;
+  if((dly - 1) * TickNs - took > dlyEarlyNs)
+    dlyEarlyNs = (dly - 1) * TickNs - took;
+  if(took - dly * TickNs > dlyLateNs)
+    dlyLateNs = took - dly * TickNs;
+  Leave();
+}
+
+/*--------------- O S T i m e T i c k ( ) ---------------*/
+
+/*
+PURPOSE
+Count a tick: end the delays and pend timeouts on this tick's spoke
+that are due, and run the timer task every TmrUpdateCnt ticks. Called
+from the SysTick handler, and by Idle.c for ticks it suppressed.
+*/
+void OSTimeTick(void)
+{
+  OS_TCB *tcb;
+  OS_TCB *next;
+
+  if(OS_AppTimeTickHookPtr != NULL)
+    OS_AppTimeTickHookPtr();
+
+  Lock();
+  OSTickCtr++;
+  tcb = OSCfg_TickWheel[OSTickCtr % OSCfg_TickWheelSize].FirstPtr;
+  for(;tcb != NULL;tcb = next)
+  {
+    next = tcb->TickNextPtr;
+    if(tcb->TickCtrMatch != OSTickCtr)
+      continue;
+    if(tcb->TaskState == OS_TASK_STATE_DLY)
+      Ready(tcb,OS_ERR_NONE,0);
+    else if(tcb->TaskState == OS_TASK_STATE_PEND_TIMEOUT)
+      Ready(tcb,OS_ERR_TIMEOUT,0);
+  }
+
+  if(--OSTmrUpdateCtr == 0)
+  {
+    OSTmrUpdateCtr = TmrUpdateCnt;
+    CtrPost(&OSTmrTaskTCB.SemCtr,&OSTmrTaskTCB.SemCtr,&OSTmrTaskTCB.TS,
+            OS_OPT_POST_NO_SCHED,CPU_TS_Get32());
+  }
+  Unlock();
+}
+
+/*--------------- O S T m r C r e a t e ( ) ---------------*/
+
+void OSTmrCreate(OS_TMR *p_tmr,CPU_CHAR *p_name,OS_TICK dly,OS_TICK period,
+                 OS_OPT opt,OS_TMR_CALLBACK_PTR p_callback,
+                 void *p_callback_arg,OS_ERR *p_err)
+{
+  Lock();
+  p_tmr->NamePtr = p_name;
+  p_tmr->CallbackPtr = p_callback;
+  p_tmr->CallbackPtrArg = p_callback_arg;
+  p_tmr->Dly = dly;
+  p_tmr->Period = period;
+  p_tmr->Remain = 0;
+  p_tmr->Opt = opt;
+  p_tmr->State = OS_TMR_STATE_STOPPED;
+  p_tmr->HostLastNs = 0;
+  p_tmr->NextPtr = tmrList;
+  tmrList = p_tmr;
+  Leave();
+
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S T m r S t a r t ( ) ---------------*/
+
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr,OS_ERR *p_err)
+{
+  Lock();
+  p_tmr->Remain = (p_tmr->Dly != 0) ? p_tmr->Dly : p_tmr->Period;
+  p_tmr->State = OS_TMR_STATE_RUNNING;
+  Leave();
+
+  *p_err = OS_ERR_NONE;
+
+  return DEF_TRUE;
+}
+
+/*--------------- O S S t a t T a s k C P U U s a g e I n i t ( ) ---------------*/
+
+void OSStatTaskCPUUsageInit(OS_ERR *p_err)
+{
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- H o s t T a s k C p u N s ( ) ---------------*/
+
+/*
+PURPOSE
+Read a task's CPU time.
+
+INPUT PARAMETERS
+tcb - the task
+
+RETURN VALUE
+Nanoseconds its thread has run
+*/
+CPU_INT64U HostTaskCpuNs(OS_TCB *tcb)
+{
+  clockid_t clock;
+  struct timespec ts;
+
+  if(pthread_getcpuclockid(tcb->HostThread,&clock) != 0 ||
+     clock_gettime(clock,&ts) != 0)
+    return 0;
+
+  return (CPU_INT64U) ts.tv_sec * NsPerSec + ts.tv_nsec;
+}
+
+/*--------------- H o s t T i m e G e t ( ) ---------------*/
+
+/*
+PURPOSE
+Report how the kernel kept time against the target's.
+
+INPUT PARAMETERS
+time - where to return the figures
+*/
+void HostTimeGet(HostTimeStats *time)
+{
+  Lock();
+  time->ticks = OSTickCtr;
+  time->ticksNs = HostTickNs();
+  time->stolenNs = HostStolenNs();
+  time->delays = delays;
+  time->dlyEarlyNs = dlyEarlyNs;
+  time->dlyLateNs = dlyLateNs;
+  time->periods = periods;
+  time->tmrOffNs = tmrOffNs;
+  Unlock();
+}
+
+/*--------------- L o c k ( ) ---------------*/
+
+/*
+PURPOSE
+Enter the kernel. Interrupts wait until it is left.
+*/
+static void Lock(void)
+{
+  pthread_mutex_lock(&hostLock);
+  hostKernel = DEF_TRUE;
+  kernelTs = (CPU_TS) HostTargetNs();
+}
+
+/*--------------- U n l o c k ( ) ---------------*/
+
+static void Unlock(void)
+{
+  KernelOut();
+  hostKernel = DEF_FALSE;
+  pthread_mutex_unlock(&hostLock);
+}
+
+/*--------------- L e a v e ( ) ---------------*/
+
+/*
+PURPOSE
+Leave the kernel and take the interrupts that came meanwhile.
+*/
+static void Leave(void)
+{
+  Unlock();
+  HostIntWindow();
+}
+
+/*--------------- K e r n e l O u t ( ) ---------------*/
+
+/*
+PURPOSE
+End the kernel section begun at kernelTs: count it as interrupts
+disabled, unless ISR posts are deferred.
+*/
+static void KernelOut(void)
+{
+#if OS_CFG_ISR_POST_DEFERRED_EN == 0u
+  HostIntDisCount((CPU_TS) HostTargetNs() - kernelTs);
+#endif
+}
+
+/*--------------- W a i t T u r n ( ) ---------------*/
+
+/*
+PURPOSE
+Wait until a task is the one running. Called with hostLock held.
+
+INPUT PARAMETERS
+tcb - the task
+*/
+static void WaitTurn(OS_TCB *tcb)
+{
+  while(OSTCBCurPtr != tcb)
+    pthread_cond_wait(&tcb->HostRun,&hostLock);
+  hostKernel = DEF_TRUE;
+  kernelTs = (CPU_TS) HostTargetNs();
+}
+
+/*--------------- H i g h e s t ( ) ---------------*/
+
+/*
+PURPOSE
+Find the task that should run: the highest priority ready task,
+staying with the current task among equals, else the one ready
+longest.
+
+RETURN VALUE
+The task; the idle task is always ready
+*/
+static OS_TCB *Highest(void)
+{
+  OS_TCB *tcb;
+  OS_TCB *best = NULL;
+
+  for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+  {
+    if(tcb->TaskState != OS_TASK_STATE_RDY)
+      continue;
+    if(best == NULL || tcb->Prio < best->Prio)
+      best = tcb;
+    else if(tcb->Prio == best->Prio && best != OSTCBCurPtr &&
+            (tcb == OSTCBCurPtr || tcb->HostSeq < best->HostSeq))
+      best = tcb;
+  }
+
+  return best;
+}
+
+/*--------------- S c h e d ( ) ---------------*/
+
+/*
+PURPOSE
+Switch to the task that should run, unless in an interrupt handler or
+the scheduler is locked. Called with hostLock held.
+*/
+static void Sched(void)
+{
+  OS_TCB *self = OSTCBCurPtr;
+  OS_TCB *next;
+
+  if(!OSRunning || OSIntNestingCtr > 0)
+    return;
+  if(OSSchedLockNestingCtr > 0 && self->TaskState == OS_TASK_STATE_RDY)
+    return;
+
+  next = Highest();
+  if(next != self)
+    Switch(next);
+}
+
+/*--------------- S w i t c h ( ) ---------------*/
+
+/*
+PURPOSE
+Hand the CPU to another task and wait for it back. PRIMASK and
+BASEPRI go with the task, as they do through PendSV on the target,
+where the switch itself runs with interrupts enabled.
+
+INPUT PARAMETERS
+next - the task to run
+*/
+static void Switch(OS_TCB *next)
+{
+  OS_TCB *self = OSTCBCurPtr;
+
+  OSTCBHighRdyPtr = next;
+  if(OS_AppTaskSwHookPtr != NULL)
+    OS_AppTaskSwHookPtr();
+
+  self->HostPrimask = hostPrimask;
+  self->HostBasepri = hostBasepri;
+  hostPrimask = next->HostPrimask;
+  hostBasepri = next->HostBasepri;
+
+  OSTaskCtxSwCtr++;
+  next->CtxSwCtr++;
+  KernelOut();
+  kernelTs = (CPU_TS) HostTargetNs();
+  OSTCBCurPtr = next;
+  pthread_cond_signal(&next->HostRun);
+
+  if(self->TaskState != OS_TASK_STATE_DEL)
+    WaitTurn(self);
+}
+
+/*--------------- R e a d y ( ) ---------------*/
+
+/*
+PURPOSE
+Make a task ready, ending its pend or delay.
+
+INPUT PARAMETERS
+tcb - the task
+err - how the pend ended
+ts  - when the post was made
+*/
+static void Ready(OS_TCB *tcb,OS_ERR err,CPU_TS ts)
+{
+  TickRemove(tcb);
+  tcb->TaskState = OS_TASK_STATE_RDY;
+  tcb->HostPendOn = NULL;
+  tcb->HostPendErr = err;
+  tcb->TS = ts;
+  tcb->HostSeq = ++seq;
+}
+
+/*--------------- T i c k I n s e r t ( ) ---------------*/
+
+/*
+PURPOSE
+Put a task on the tick wheel, on the spoke of the tick its delay or
+timeout ends on. Called with hostLock held.
+
+INPUT PARAMETERS
+tcb   - the task
+ticks - ticks from now
+*/
+static void TickInsert(OS_TCB *tcb,OS_TICK ticks)
+{
+  OS_TICK_SPOKE *spoke;
+
+  tcb->TickCtrMatch = OSTickCtr + ticks;
+  spoke = &OSCfg_TickWheel[tcb->TickCtrMatch % OSCfg_TickWheelSize];
+
+  tcb->TickSpokePtr = spoke;
+  tcb->TickPrevPtr = NULL;
+  tcb->TickNextPtr = spoke->FirstPtr;
+  if(spoke->FirstPtr != NULL)
+    spoke->FirstPtr->TickPrevPtr = tcb;
+  spoke->FirstPtr = tcb;
+  spoke->NbrEntries++;
+}
+
+/*--------------- T i c k R e m o v e ( ) ---------------*/
+
+/*
+PURPOSE
+Take a task off the tick wheel, if it is on it. Called with hostLock
+held.
+
+INPUT PARAMETERS
+tcb - the task
+*/
+static void TickRemove(OS_TCB *tcb)
+{
+  OS_TICK_SPOKE *spoke = tcb->TickSpokePtr;
+
+  if(spoke == NULL)
+    return;
+
+  if(tcb->TickPrevPtr != NULL)
+    tcb->TickPrevPtr->TickNextPtr = tcb->TickNextPtr;
+  else
+    spoke->FirstPtr = tcb->TickNextPtr;
+  if(tcb->TickNextPtr != NULL)
+    tcb->TickNextPtr->TickPrevPtr = tcb->TickPrevPtr;
+  spoke->NbrEntries--;
+
+  tcb->TickSpokePtr = NULL;
+  tcb->TickNextPtr = NULL;
+  tcb->TickPrevPtr = NULL;
+}
+
+/*--------------- P e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Block the running task on an object until Ready() is called for it.
+
+INPUT PARAMETERS
+obj     - the object
+timeout - ticks to wait, 0 for ever
+*/
+static void Pend(void *obj,OS_TICK timeout)
+{
+  OS_TCB *self = OSTCBCurPtr;
+
+  self->HostPendOn = obj;
+  self->HostSeq = ++seq;
+  if(timeout != 0)
+  {
+    self->TaskState = OS_TASK_STATE_PEND_TIMEOUT;
+    TickInsert(self,timeout);
+  }
+  else
+    self->TaskState = OS_TASK_STATE_PEND;
+
+  Sched();
+}
+
+/*--------------- W a i t e r ( ) ---------------*/
+
+/*
+PURPOSE
+Find the task a post to an object goes to: the highest priority one
+pending on it, first come first served among equals.
+
+INPUT PARAMETERS
+obj - the object
+
+RETURN VALUE
+The task, or NULL if none is pending
+*/
+static OS_TCB *Waiter(void *obj)
+{
+  OS_TCB *tcb;
+  OS_TCB *best = NULL;
+
+  for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+    if(tcb->HostPendOn == obj &&
+       (best == NULL || tcb->Prio < best->Prio ||
+        (tcb->Prio == best->Prio && tcb->HostSeq < best->HostSeq)))
+      best = tcb;
+
+  return best;
+}
+
+/*--------------- C t r P e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Pend on a counting semaphore, a kernel one or a task's own.
+
+INPUT PARAMETERS
+obj     - the semaphore, as posts find it
+ctr     - its count
+objTs   - when it was last posted
+timeout - ticks to wait, 0 for ever
+opt     - OS_OPT_PEND_BLOCKING or OS_OPT_PEND_NON_BLOCKING
+p_ts    - where to return when the post was made, or NULL
+p_err   - where to return the error
+
+RETURN VALUE
+The count left
+*/
+static OS_SEM_CTR CtrPend(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,
+                          OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                          OS_ERR *p_err)
+{
+  OS_TCB *self = OSTCBCurPtr;
+  OS_SEM_CTR left;
+
+  Lock();
+  if(*ctr > 0)
+  {
+    (*ctr)--;
+    *p_err = OS_ERR_NONE;
+    if(p_ts != NULL)
+      *p_ts = *objTs;
+  }
+  else if(opt & OS_OPT_PEND_NON_BLOCKING)
+  {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    if(p_ts != NULL)
+      *p_ts = 0;
+  }
+  else
+  {
+    Pend(obj,timeout);
+    *p_err = self->HostPendErr;
+    if(p_ts != NULL)
+      *p_ts = self->TS;
+  }
+  left = *ctr;
+  Leave();
+
+  return left;
+}
+
+/*--------------- C t r P o s t ( ) ---------------*/
+
+/*
+PURPOSE
+Post a counting semaphore: wake the task it goes to, or count it.
+
+INPUT PARAMETERS
+obj   - the semaphore, as pends name it
+ctr   - its count
+objTs - when it was last posted
+opt   - OS_OPT_POST_ALL and OS_OPT_POST_NO_SCHED may be set
+ts    - when the post was made
+
+RETURN VALUE
+The count
+*/
+static OS_SEM_CTR CtrPost(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,
+                          OS_OPT opt,CPU_TS ts)
+{
+  OS_TCB *tcb;
+  CPU_BOOLEAN nested = hostKernel;
+  OS_SEM_CTR count;
+
+  if(!nested)
+    Lock();
+
+  tcb = Waiter(obj);
+  if(tcb == NULL)
+  {
+    (*ctr)++;
+    *objTs = ts;
+  }
+  while(tcb != NULL)
+  {
+    Ready(tcb,OS_ERR_NONE,ts);
+    tcb = (opt & OS_OPT_POST_ALL) ? Waiter(obj) : NULL;
+  }
+  count = *ctr;
+
+  if(!nested)
+  {
+    if(!(opt & OS_OPT_POST_NO_SCHED))
+      Sched();
+    Leave();
+  }
+
+  return count;
+}
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+/*--------------- I n t Q P o s t ( ) ---------------*/
+
+/*
+PURPOSE
+Queue a semaphore post made in an interrupt handler for the ISR
+handler task, as OS_IntQPost() does, with interrupts disabled only
+for the queue. The first entry wakes the task, which empties the
+queue before it pends again.
+
+INPUT PARAMETERS
+obj   - the semaphore, as pends name it
+ctr   - its count
+objTs - when it was last posted
+opt   - the post's options
+p_err - where to return the error: OS_ERR_INT_Q_FULL if no entry was
+        free, and the post is lost
+*/
+static void IntQPost(void *obj,OS_SEM_CTR *ctr,CPU_TS *objTs,OS_OPT opt,
+                     OS_ERR *p_err)
+{
+  IntQEntry *entry;
+  CPU_SR_ALLOC();
+
+  CPU_CRITICAL_ENTER();
+  if(OSIntQNbrEntries >= OS_CFG_INT_Q_SIZE)
+  {
+    OSIntQOvfCtr++;
+    CPU_CRITICAL_EXIT();
+    *p_err = OS_ERR_INT_Q_FULL;
+    return;
+  }
+
+  entry = &intQ[intQIn];
+  if(++intQIn == OS_CFG_INT_Q_SIZE)
+    intQIn = 0;
+  entry->obj = obj;
+  entry->ctr = ctr;
+  entry->objTs = objTs;
+  entry->opt = opt;
+  entry->ts = CPU_TS_Get32();
+  if(++OSIntQNbrEntries > OSIntQNbrEntriesMax)
+    OSIntQNbrEntriesMax = OSIntQNbrEntries;
+
+  if(OSIntQNbrEntries == 1)
+    CtrPost(&OSIntQTaskTCB.SemCtr,&OSIntQTaskTCB.SemCtr,&OSIntQTaskTCB.TS,
+            OS_OPT_POST_NONE,entry->ts);
+  CPU_CRITICAL_EXIT();
+
+  *p_err = OS_ERR_NONE;
+}
+#endif
+
+/*--------------- T a s k T h r e a d ( ) ---------------*/
+
+/*
+PURPOSE
+The thread of a task: wait to be run, run the task, and delete it if
+it returns.
+
+INPUT PARAMETERS
+arg - the task's TCB
+*/
+static void *TaskThread(void *arg)
+{
+  OS_TCB *tcb = arg;
+  OS_ERR osErr;
+
+  //not Lock(): until its turn, this thread must not mark the kernel busy
+  pthread_mutex_lock(&hostLock);
+  WaitTurn(tcb);
+  Leave();
+
+  tcb->HostEntry(tcb->HostArg);
+
+  if(OS_AppTaskReturnHookPtr != NULL)
+    OS_AppTaskReturnHookPtr(tcb);
+  OSTaskDel(tcb,&osErr);
+
+  return NULL;
+}
+
+/*--------------- I d l e T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Run the idle hook for ever. If the hook didn't wait for an interrupt
+itself, wait here; the host can't spin, as interrupts are only taken
+at kernel calls and critical section exits.
+*/
+static void IdleTask(void *p_arg)
+{
+  CPU_SR_ALLOC();
+
+  (void) p_arg;
+  for(;;)
+  {
+    if(OS_AppIdleTaskHookPtr != NULL)
+      OS_AppIdleTaskHookPtr();
+
+    if(!HostIntTaken())
+    {
+      CPU_CRITICAL_ENTER();
+      HostWfi();
+      CPU_CRITICAL_EXIT();
+      HostIntTaken();
+    }
+
+    HostIdleDone();
+  }
+}
+
+/*--------------- S t a t T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+At OS_CFG_STAT_TASK_RATE_HZ, set every task's CPUUsage from its
+thread's CPU time, and the total in OSStatTaskCPUUsage, then run the
+statistics hook. Usage is in hundredths of a percent, as V3.03 keeps
+it.
+*/
+static void StatTask(void *p_arg)
+{
+  OS_ERR osErr;
+  OS_TCB *tcb;
+  CPU_INT64U now;
+  CPU_INT64U last = HostNow();
+  CPU_INT64U cpu;
+  CPU_INT64U usage;
+  CPU_INT64U total;
+
+  (void) p_arg;
+  for(;;)
+  {
+    OSTimeDly(OS_CFG_TICK_RATE_HZ / OS_CFG_STAT_TASK_RATE_HZ,
+              OS_OPT_TIME_DLY,&osErr);
+
+    now = HostNow();
+    total = 0;
+    OSSchedLock(&osErr);
+    for(tcb = OSTaskDbgListPtr;tcb != NULL;tcb = tcb->DbgNextPtr)
+    {
+      cpu = HostTaskCpuNs(tcb);
+      usage = (cpu - tcb->HostCpuNs) * 10000u / (now - last);
+      tcb->HostCpuNs = cpu;
+      tcb->CPUUsage = (OS_CPU_USAGE) ((usage > 10000u) ? 10000u : usage);
+      if(tcb != &OSIdleTaskTCB)
+        total += tcb->CPUUsage;
+    }
+    OSStatTaskCPUUsage = (OS_CPU_USAGE) ((total > 10000u) ? 10000u : total);
+    OSSchedUnlock(&osErr);
+    last = now;
+
+    if(OS_AppStatTaskHookPtr != NULL)
+      OS_AppStatTaskHookPtr();
+  }
+}
+
+/*--------------- T m r T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+Run the timers, signalled by OSTimeTick() at OS_CFG_TMR_TASK_RATE_HZ.
+Callbacks run with the scheduler locked, as on the target. Each
+periodic callback is timed from the last.
+*/
+static void TmrTask(void *p_arg)
+{
+  OS_ERR osErr;
+  OS_TMR *tmr;
+  CPU_INT64U now;
+  CPU_INT64S off;
+
+  (void) p_arg;
+  for(;;)
+  {
+    OSTaskSemPend(0,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+
+    OSSchedLock(&osErr);
+    for(tmr = tmrList;tmr != NULL;tmr = tmr->NextPtr)
+    {
+      if(tmr->State != OS_TMR_STATE_RUNNING || --tmr->Remain > 0)
+        continue;
+
+      if(tmr->Opt == OS_OPT_TMR_PERIODIC)
+      {
+        tmr->Remain = tmr->Period;
+
+        now = HostTargetNs();
+        if(tmr->HostLastNs != 0)
+        {
+          off = (CPU_INT64S) (now - tmr->HostLastNs) -
+                tmr->Period * TmrUpdateCnt * TickNs;
+          if(off < 0)
+            off = -off;
+          if(off > tmrOffNs)
+            tmrOffNs = off;
+          periods++;
+        }
+        tmr->HostLastNs = now;
+      }
+      else
+        tmr->State = OS_TMR_STATE_STOPPED;
+      if(tmr->CallbackPtr != NULL)
+        tmr->CallbackPtr(tmr,tmr->CallbackPtrArg);
+    }
+    OSSchedUnlock(&osErr);
+  }
+}
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+/*--------------- I n t Q T a s k ( ) ---------------*/
+
+/*
+PURPOSE
+The ISR handler task: make the posts interrupt handlers queued, in
+order and with the scheduler locked, as OS_IntQTask() does, then
+schedule once for them all.
+*/
+static void IntQTask(void *p_arg)
+{
+  OS_ERR osErr;
+  IntQEntry entry;
+  CPU_SR_ALLOC();
+
+  (void) p_arg;
+  for(;;)
+  {
+    OSTaskSemPend(0,OS_OPT_PEND_BLOCKING,NULL,&osErr);
+
+    OSSchedLock(&osErr);
+    for(;;)
+    {
+      CPU_CRITICAL_ENTER();
+      if(OSIntQNbrEntries == 0)
+      {
+        CPU_CRITICAL_EXIT();
+        break;
+      }
+      entry = intQ[intQOut];
+      if(++intQOut == OS_CFG_INT_Q_SIZE)
+        intQOut = 0;
+      OSIntQNbrEntries--;
+      CPU_CRITICAL_EXIT();
+
+      CtrPost(entry.obj,entry.ctr,entry.objTs,
+              entry.opt | OS_OPT_POST_NO_SCHED,entry.ts);
+    }
+    OSSchedUnlock(&osErr);
+  }
+}
+#endif
@@ -0,0 +1,57 @@
+#ifndef __hostport__
+#define __hostport__
+/*--------------- H o s t P o r t . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Included ahead of every file of the host build (gcc -include). Maps
+the Cortex-M3 specifics the application reaches directly onto the
+host's CPU model in HostCPU.c, using the overrides the application
+headers leave for this. SETENA1 and IPR38 need none: HostCPU.c backs
+the System Control Space page with memory.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Every SysTick register goes through HostCPU.c
+*/
+#include <stdint.h>
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void HostAsm(const char *instr,const char *file,int line);
+uint32_t HostGetBasepri(void);
+void HostSetBasepri(uint32_t basepri);
+volatile uint32_t *HostSystCsr(void);
+volatile uint32_t *HostSystRvr(void);
+volatile uint32_t *HostSystCvr(void);
+volatile uint32_t *HostIcsr(void);
+volatile uint32_t *HostIspr1(void);
+void HostRts(uint8_t on);
+
+/*----- C o r t e x - M 3 -----*/
+
+// cpsid i, cpsie i, wfi and the BKPT of a failed assert
+#define asm(instr) HostAsm(instr,__FILE__,__LINE__)
+
+// Intrpt.h
+#define IntGetBasepri() HostGetBasepri()
+#define IntSetBasepri(basepri) HostSetBasepri(basepri)
+
+// Idle.h: SysTick counts down from SYST_RVR as on the target, and the
+// tickless idle mode reprograms it
+#define SYST_CSR (*HostSystCsr())
+#define SYST_RVR (*HostSystRvr())
+#define SYST_CVR (*HostSystCvr())
+#define SCB_ICSR (*HostIcsr())
+#define NVIC_ISPR1 (*HostIspr1())
+
+// SerIODriver.h: RTS goes to the simulated sender
+#define RtsInit() ((void) 0)
+#define RtsOn() HostRts(1)
+#define RtsOff() HostRts(0)
+
+#endif
@@ -0,0 +1,474 @@
+/*--------------- H o s t U a r t . c ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+The simulated USART2, with a sender on RX fed from a file or pipe and
+a receiver on TX that writes to stdout.
+
+The application reads and writes the register block directly, so the
+host can't see a read of DR. Instead RX and TX get separate calls of
+SerialISR(): an RX call shows RXNE with the byte in DR, and the byte
+was read unless ServiceRx() masked RXIE; a TX call shows TXE with an
+impossible value in DR, and a byte was written if DR changed.
+
+The sender starts once the application first enables RXIE, and then
+sends a byte every gap; with no gap, one at every point where an
+interrupt could be taken, which is as fast as the application can
+possibly keep up. The host runs much slower than the target between
+those points, so one that comes late delays the next byte rather than
+sending all those due at once. A byte that comes while the last waits
+under a masked RXIE overruns, unless lossless is set, when the sender
+waits for DR to be read instead. It honours RTS, and XOFF and XON sent on TX when the
+build uses FlowXonXoff.
+
+The receiver takes a byte every txNs, or at once.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Host.h"
+#include "SerIODriver.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+
+#define InSize 65536            // Bytes read ahead from the input
+#define TxMarker 0xFFFF         // DR before a TX call, not a byte
+#define RxieEna 0x20            // CR1: RXNE interrupt enable
+#define TxieEna 0x80            // CR1: TXE interrupt enable
+
+#define IsrNone 0
+#define IsrRx 1
+#define IsrTx 2
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+USART_TypeDef hostUsart2;
+GPIO_TypeDef hostGpiod;
+
+// Input read ahead by the reader thread
+static pthread_mutex_t inLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t inData;      // Timed on CLOCK_MONOTONIC
+static pthread_cond_t inSpace = PTHREAD_COND_INITIALIZER;
+static CPU_INT08U inBfr[InSize];
+static CPU_INT32U inHead;
+static CPU_INT32U inCount;
+static CPU_BOOLEAN inEof;
+static int inFd;
+static CPU_INT32U inRepeat;
+
+// The sender
+static CPU_INT64U gap;          // Between bytes, 0 for back to back
+static CPU_BOOLEAN lossless;    // Never overrun
+static CPU_BOOLEAN rxOn;        // The sender has started
+static CPU_INT64U rxDue;        // When the next byte is sent
+static CPU_BOOLEAN rxFull;      // RXNE: a byte waits in rxByte
+static CPU_INT08U rxByte;
+static CPU_BOOLEAN rxOverrun;   // ORE
+static CPU_BOOLEAN rtsOff;      // Paused by RTS
+static CPU_BOOLEAN xoff;        // Paused by XOFF
+
+// The receiver
+static FILE *txOut;
+static CPU_INT64U txTime;       // Per byte, 0 to take them at once
+static CPU_INT64U txDue;        // When DR is free again
+static CPU_BOOLEAN txEmpty = DEF_TRUE;   // TXE
+
+static CPU_INT08U isrKind;      // Which call of SerialISR() is running
+static HostUartStats stats;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+
+static void *Reader(void *arg);
+static CPU_BOOLEAN Paused(void);
+static CPU_BOOLEAN CanSend(CPU_INT64U now);
+static void Send(CPU_INT64U now);
+static void Received(CPU_INT08U c,CPU_INT64U now);
+
+/*--------------- H o s t U a r t O p e n ( ) ---------------*/
+
+/*
+PURPOSE
+Set up the sender and receiver and start reading the input.
+
+INPUT PARAMETERS
+path     - input file, NULL for stdin
+repeat   - times to send it; more than once needs a file
+gapNs    - between RX bytes, 0 for back to back
+noLoss   - TRUE to hold each RX byte until the last was read
+txNs     - per TX byte, 0 for no wait
+out      - where TX bytes go
+*/
+void HostUartOpen(const char *path,CPU_INT32U repeat,CPU_INT64U gapNs,
+                  CPU_BOOLEAN noLoss,CPU_INT64U txNs,FILE *out)
+{
+  pthread_t reader;
+  pthread_condattr_t attr;
+
+  inFd = (path == NULL) ? STDIN_FILENO : open(path,O_RDONLY);
+  if(inFd < 0)
+    HostFatal("can't open the input");
+  if(repeat > 1 && lseek(inFd,0,SEEK_SET) < 0)
+    HostFatal("repeating needs an input file");
+  inRepeat = (repeat > 0) ? repeat : 1;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+  pthread_cond_init(&inData,&attr);
+  pthread_condattr_destroy(&attr);
+
+  gap = gapNs;
+  lossless = noLoss;
+  txTime = txNs;
+  txOut = out;
+
+  if(pthread_create(&reader,NULL,Reader,NULL) != 0)
+    HostFatal("can't create the reader thread");
+}
+
+/*--------------- H o s t U a r t P o l l ( ) ---------------*/
+
+/*
+PURPOSE
+Bring the sender and receiver up to the present.
+
+INPUT PARAMETERS
+now    - HostNow()
+arrive - TRUE if a back to back byte may come now
+
+RETURN VALUE
+TRUE if USART2 is asking for an interrupt
+*/
+CPU_BOOLEAN HostUartPoll(CPU_INT64U now,CPU_BOOLEAN arrive)
+{
+  if(!txEmpty && now >= txDue)
+    txEmpty = DEF_TRUE;
+
+  //nothing is sent before the application is listening
+  if(!rxOn && (USART2->CR1 & RxieEna))
+  {
+    rxOn = DEF_TRUE;
+    rxDue = now;
+  }
+
+  if(gap == 0)
+  {
+    if(arrive && CanSend(now))
+      Send(now);
+  }
+  else if(now >= rxDue)
+  {
+    //a late poll stretches the line rather than overrunning bytes the
+    //target would have read in time
+    if(CanSend(now))
+      Send(now);
+    rxDue = (now - rxDue < gap) ? rxDue + gap : now + gap;
+  }
+
+  return (rxFull && (USART2->CR1 & RxieEna)) ||
+         (txEmpty && (USART2->CR1 & TxieEna));
+}
+
+/*--------------- H o s t U a r t N e x t E v e n t ( ) ---------------*/
+
+/*
+PURPOSE
+Find when the sender or receiver will next change anything by
+itself, for the idle wait.
+
+INPUT PARAMETERS
+now - HostNow()
+
+RETURN VALUE
+The time, now if at once, ~0 if not until more input comes
+*/
+CPU_INT64U HostUartNextEvent(CPU_INT64U now)
+{
+  CPU_INT64U next = ~0ULL;
+
+  if(!txEmpty)
+    next = txDue;
+
+  pthread_mutex_lock(&inLock);
+  if(CanSend(now))
+  {
+    if(gap == 0)
+      next = now;
+    else if(rxDue < next)
+      next = rxDue;
+  }
+  pthread_mutex_unlock(&inLock);
+
+  return next;
+}
+
+/*--------------- H o s t U a r t W a i t ( ) ---------------*/
+
+/*
+PURPOSE
+Sleep until a time, or until more input comes.
+
+INPUT PARAMETERS
+until - HostNow() to wake at
+*/
+void HostUartWait(CPU_INT64U until)
+{
+  struct timespec ts;
+  CPU_INT64U limit = HostNow() + NsPerSec;
+
+  if(until > limit)
+    until = limit;
+  ts.tv_sec = until / NsPerSec;
+  ts.tv_nsec = until % NsPerSec;
+
+  pthread_mutex_lock(&inLock);
+  if(inCount == 0 && !inEof)
+  {
+    pthread_cond_timedwait(&inData,&inLock,&ts);
+    pthread_mutex_unlock(&inLock);
+  }
+  else
+  {
+    pthread_mutex_unlock(&inLock);
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&ts,NULL);
+  }
+}
+
+/*--------------- H o s t U a r t I s r ( ) ---------------*/
+
+/*
+PURPOSE
+Take the USART2 interrupt: an RX call of SerialISR() if RXNE and RXIE
+are set, else a TX call.
+*/
+void HostUartIsr(void)
+{
+  if(rxFull && (USART2->CR1 & RxieEna))
+  {
+    isrKind = IsrRx;
+    USART2->SR = USART_RXNE | (rxOverrun ? USART_ORE : 0);
+    USART2->DR = rxByte;
+  }
+  else
+  {
+    isrKind = IsrTx;
+    USART2->SR = USART_TXE;
+    USART2->DR = TxMarker;
+  }
+
+  SerialISR();
+}
+
+/*--------------- H o s t U a r t I s r D o n e ( ) ---------------*/
+
+/*
+PURPOSE
+See what the handler did to the registers. Called by OSIntExit().
+*/
+void HostUartIsrDone(void)
+{
+  CPU_INT64U now = HostNow();
+
+  if(isrKind == IsrRx && (USART2->CR1 & RxieEna))
+  {
+    //read, rather than left for later by masking RXIE
+    rxFull = DEF_FALSE;
+    rxOverrun = DEF_FALSE;
+    stats.delivered++;
+    stats.lastNs = now;
+  }
+  else if(isrKind == IsrTx && USART2->DR != TxMarker)
+    Received((CPU_INT08U) USART2->DR,now);
+
+  isrKind = IsrNone;
+  USART2->SR = 0;
+}
+
+/*--------------- H o s t R t s ( ) ---------------*/
+
+/*
+PURPOSE
+Drive RTS; the sender stops while it is off.
+
+INPUT PARAMETERS
+on - TRUE when ready to receive
+*/
+void HostRts(uint8_t on)
+{
+  if(!on && !rtsOff)
+    stats.pauses++;
+  rtsOff = !on;
+}
+
+/*--------------- H o s t U a r t D o n e ( ) ---------------*/
+
+/*
+PURPOSE
+Tell whether the run is over: all the input sent and read, and
+nothing on either side for a while.
+
+INPUT PARAMETERS
+now    - HostNow()
+quietNs - how long nothing must have happened
+
+RETURN VALUE
+TRUE if it is over
+*/
+CPU_BOOLEAN HostUartDone(CPU_INT64U now,CPU_INT64U quietNs)
+{
+  CPU_BOOLEAN done;
+
+  pthread_mutex_lock(&inLock);
+  done = inEof && inCount == 0;
+  pthread_mutex_unlock(&inLock);
+
+  return done && !rxFull && now - stats.lastNs >= quietNs;
+}
+
+/*--------------- H o s t U a r t S t a t s G e t ( ) ---------------*/
+
+void HostUartStatsGet(HostUartStats *uartStats)
+{
+  *uartStats = stats;
+}
+
+/*--------------- R e a d e r ( ) ---------------*/
+
+/*
+PURPOSE
+Read the input ahead of the sender, inRepeat times over.
+*/
+static void *Reader(void *arg)
+{
+  CPU_INT32U tail;
+  CPU_INT32U room;
+  ssize_t got;
+
+  (void) arg;
+  for(;;)
+  {
+    pthread_mutex_lock(&inLock);
+    while(inCount == InSize)
+      pthread_cond_wait(&inSpace,&inLock);
+    tail = (inHead + inCount) % InSize;
+    room = (tail >= inHead) ? InSize - tail : inHead - tail;
+    if(room > InSize - inCount)
+      room = InSize - inCount;
+    pthread_mutex_unlock(&inLock);
+
+    got = read(inFd,inBfr + tail,room);
+    if(got == 0 && --inRepeat > 0 && lseek(inFd,0,SEEK_SET) == 0)
+      continue;
+
+    pthread_mutex_lock(&inLock);
+    if(got <= 0)
+      inEof = DEF_TRUE;
+    else
+      inCount += got;
+    pthread_cond_signal(&inData);
+    pthread_mutex_unlock(&inLock);
+
+    if(got <= 0)
+      return NULL;
+  }
+}
+
+/*--------------- P a u s e d ( ) ---------------*/
+
+static CPU_BOOLEAN Paused(void)
+{
+  return rtsOff || xoff;
+}
+
+/*--------------- C a n S e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Tell whether the sender has a byte it may send now. It waits for DR
+to be read while RXIE is on: the ISR would take the byte as soon as
+the host got to it, and the host is too slow to tell a late interrupt
+from one held off. Only a byte left unread under a masked RXIE is
+overrun, and with lossless set none is.
+*/
+static CPU_BOOLEAN CanSend(CPU_INT64U now)
+{
+  (void) now;
+
+  return rxOn && inCount > 0 && !Paused() &&
+         !(rxFull && (lossless || (USART2->CR1 & RxieEna)));
+}
+
+/*--------------- S e n d ( ) ---------------*/
+
+/*
+PURPOSE
+Send the next input byte to RX. It overruns the byte in DR if that
+hasn't been read.
+*/
+static void Send(CPU_INT64U now)
+{
+  CPU_INT08U c;
+
+  pthread_mutex_lock(&inLock);
+  c = inBfr[inHead];
+  inHead = (inHead + 1) % InSize;
+  inCount--;
+  pthread_cond_signal(&inSpace);
+  pthread_mutex_unlock(&inLock);
+
+  if(stats.offered++ == 0)
+    stats.firstNs = now;
+
+  if(rxFull)
+  {
+    rxOverrun = DEF_TRUE;
+    stats.lost++;
+  }
+  else
+  {
+    rxByte = c;
+    rxFull = DEF_TRUE;
+  }
+}
+
+/*--------------- R e c e i v e d ( ) ---------------*/
+
+/*
+PURPOSE
+Take a byte ServiceTx() wrote to DR.
+
+INPUT PARAMETERS
+c   - the byte
+now - HostNow()
+*/
+static void Received(CPU_INT08U c,CPU_INT64U now)
+{
+  stats.sent++;
+  stats.lastNs = now;
+  if(txTime != 0)
+  {
+    txEmpty = DEF_FALSE;
+    txDue = now + txTime;
+  }
+
+#if RxFlow == FlowXonXoff
+  if(c == XOFF || c == XON)
+  {
+    if(c == XOFF && !xoff)
+      stats.pauses++;
+    xoff = (c == XOFF);
+    return;
+  }
+#endif
+
+  putc(c,txOut);
+}
@@ -0,0 +1,11 @@
+/*--------------- C P U . h ---------------*/
+
+/*
+PURPOSE
+Intrpt.h includes "CPU.h"; IAR on Windows finds cpu.h that way, a
+case sensitive host file system doesn't.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <cpu.h>
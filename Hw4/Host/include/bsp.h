@@ -0,0 +1,22 @@
+#ifndef __bsp__
+#define __bsp__
+/*--------------- b s p . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the eval board BSP. Implemented in HostCPU.c; the
+serial port itself is the simulated USART2.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <cpu.h>
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void BSP_Init(void);
+void BSP_IntDisAll(void);
+CPU_INT32U BSP_CPU_ClkFreq(void);
+void BSP_Ser_Init(CPU_INT32U baud_rate);
+void BSP_Ser_Printf(CPU_CHAR *format,...);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __cpu__
+#define __cpu__
+/*--------------- c p u . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Host stand-in for uC/CPU: the CPU_ types on an LP64 host, PRIMASK
+critical sections, the CPU_TS timestamp and interrupts disabled time
+measurement. Implemented in HostCPU.c.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <stdint.h>
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef void CPU_VOID;
+typedef char CPU_CHAR;
+typedef uint8_t CPU_BOOLEAN;
+typedef uint8_t CPU_INT08U;
+typedef int8_t CPU_INT08S;
+typedef uint16_t CPU_INT16U;
+typedef int16_t CPU_INT16S;
+typedef uint32_t CPU_INT32U;
+typedef int32_t CPU_INT32S;
+typedef uint64_t CPU_INT64U;
+typedef int64_t CPU_INT64S;
+typedef float CPU_FP32;
+typedef double CPU_FP64;
+
+typedef uint32_t CPU_DATA;
+typedef uintptr_t CPU_ADDR;
+typedef size_t CPU_SIZE_T;
+typedef uint32_t CPU_STK;
+typedef uint32_t CPU_STK_SIZE;
+typedef uint32_t CPU_SR;
+typedef uint32_t CPU_TS;
+typedef uint32_t CPU_TS_TMR;
+typedef uint32_t CPU_TS_TMR_FREQ;
+typedef uint16_t CPU_ERR;
+
+#define CPU_ERR_NONE 0u
+
+#define CPU_CFG_TS_32_EN 1
+
+/*----- c r i t i c a l   s e c t i o n s -----*/
+
+// CPU_SR_Save() sets PRIMASK and returns the old value; restoring a
+// clear PRIMASK lets pending interrupts in, as on the Cortex-M3.
+#define CPU_SR_ALLOC() CPU_SR cpu_sr = (CPU_SR) 0
+#define CPU_CRITICAL_ENTER() do { cpu_sr = CPU_SR_Save(); } while(0)
+#define CPU_CRITICAL_EXIT() do { CPU_SR_Restore(cpu_sr); } while(0)
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void CPU_Init(void);
+CPU_SR CPU_SR_Save(void);
+void CPU_SR_Restore(CPU_SR cpu_sr);
+
+CPU_TS CPU_TS_Get32(void);
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err);
+
+CPU_TS_TMR CPU_IntDisMeasMaxCurReset(void);
+CPU_TS_TMR CPU_IntDisMeasMaxCurGet(void);
+CPU_TS_TMR CPU_IntDisMeasMaxGet(void);
+
+CPU_DATA CPU_CntLeadZeros(CPU_DATA val);
+
+#endif
@@ -0,0 +1,10 @@
+/*--------------- l i b _ a s c i i . h ---------------*/
+
+/*
+PURPOSE
+Empty host stand-in: the application uses nothing from the uC/LIB
+lib_ascii module, but includes.h includes it.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
@@ -0,0 +1,10 @@
+/*--------------- l i b _ c f g . h ---------------*/
+
+/*
+PURPOSE
+Empty host stand-in: the uC/LIB defaults suit the application, but
+app_cfg.h includes it.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
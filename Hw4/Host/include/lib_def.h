@@ -0,0 +1,27 @@
+#ifndef __lib_def__
+#define __lib_def__
+/*--------------- l i b _ d e f . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the uC/LIB constants the application uses.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+
+#define DEF_DISABLED 0u
+#define DEF_ENABLED 1u
+
+#define DEF_FALSE 0u
+#define DEF_TRUE 1u
+
+#define DEF_NO 0u
+#define DEF_YES 1u
+
+#define DEF_OFF 0u
+#define DEF_ON 1u
+
+#define DEF_NULL ((void *) 0)
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __lib_mem__
+#define __lib_mem__
+/*--------------- l i b _ m e m . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the uC/LIB memory functions, on the C library.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <string.h>
+
+#define Mem_Clr(pmem,size) ((void) memset((pmem),0,(size)))
+#define Mem_Set(pmem,data_val,size) ((void) memset((pmem),(data_val),(size)))
+#define Mem_Copy(pdest,psrc,size) ((void) memcpy((pdest),(psrc),(size)))
+#define Mem_Cmp(p1_mem,p2_mem,size) (memcmp((p1_mem),(p2_mem),(size)) == 0)
+
+#endif
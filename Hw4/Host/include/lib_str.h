@@ -0,0 +1,20 @@
+#ifndef __lib_str__
+#define __lib_str__
+/*--------------- l i b _ s t r . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the uC/LIB string functions, on the C library.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <string.h>
+
+#define Str_Len(pstr) ((CPU_SIZE_T) strlen(pstr))
+#define Str_Copy(pdest,psrc) strcpy((pdest),(psrc))
+#define Str_Copy_N(pdest,psrc,len_max) strncpy((pdest),(psrc),(len_max))
+#define Str_Cat(pdest,pstr_cat) strcat((pdest),(pstr_cat))
+#define Str_Cmp(p1_str,p2_str) strcmp((p1_str),(p2_str))
+
+#endif
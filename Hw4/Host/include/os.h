@@ -0,0 +1,265 @@
+#ifndef __os__
+#define __os__
+/*--------------- o s . h ---------------*/
+
+/*
+by:	David Tyler
+	  Embedded Real Time Systems
+	  Electrical and Computer Engineering Dept.
+	  UMASS Lowell
+
+PURPOSE
+Host stand-in for the part of the uC/OS-III V3.0x API the application
+uses. Every task is a pthread, but only the task in OSTCBCurPtr runs:
+the others wait on their own condition variable, so scheduling is the
+kernel's (highest ready priority, preemptive) rather than Linux's.
+Implemented in HostOS.c.
+
+The tick wheel and the timer task's update counter are kept as the
+V3.0x kernel keeps them, for Idle.c's tickless mode to read.
+
+OS_CFG_ISR_POST_DEFERRED_EN may be set to 1u by the build. Semaphore
+posts made in an interrupt handler then go on a queue of
+OS_CFG_INT_Q_SIZE entries, and the ISR handler task makes them at
+priority 0.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Added the tick wheel and OSTmrUpdateCtr
+10-19-2026 dwt - Deferred ISR posts when the build asks for them
+*/
+#include <pthread.h>
+#include <cpu.h>
+#include <lib_def.h>
+#include <os_cfg_app.h>
+
+/*----- c o n f i g u r a t i o n -----*/
+
+// What os_cfg.h sets for the target build
+#define OS_VERSION 30300u
+#define OS_CFG_PRIO_MAX 64u
+#define OS_CFG_APP_HOOKS_EN 1u
+#define OS_CFG_DBG_EN 1u
+#ifndef OS_CFG_ISR_POST_DEFERRED_EN
+#define OS_CFG_ISR_POST_DEFERRED_EN 0u
+#endif
+#define OS_CFG_STAT_TASK_EN 1u
+#define OS_CFG_TASK_PROFILE_EN 1u
+#define OS_CFG_TMR_EN 1u
+#define OS_CFG_TS_EN 1u
+
+/*----- t y p e    d e f i n i t i o n s -----*/
+
+typedef CPU_INT16U OS_CPU_USAGE;
+typedef CPU_INT32U OS_CTR;
+typedef CPU_INT32U OS_CTX_SW_CTR;
+typedef CPU_INT16U OS_ERR;
+typedef CPU_INT08U OS_NESTING_CTR;
+typedef CPU_INT16U OS_OBJ_QTY;
+typedef CPU_INT16U OS_OPT;
+typedef CPU_INT08U OS_PRIO;
+typedef CPU_INT32U OS_SEM_CTR;
+typedef CPU_INT08U OS_STATE;
+typedef CPU_INT32U OS_TICK;
+typedef CPU_INT16U OS_TICK_SPOKE_IX;
+typedef CPU_INT16U OS_MSG_QTY;
+
+typedef struct os_tcb OS_TCB;
+typedef struct os_tmr OS_TMR;
+
+typedef void (*OS_TASK_PTR)(void *p_arg);
+typedef void (*OS_TMR_CALLBACK_PTR)(void *p_tmr,void *p_arg);
+typedef void (*OS_APP_HOOK_VOID)(void);
+typedef void (*OS_APP_HOOK_TCB)(OS_TCB *p_tcb);
+
+struct os_tcb
+{
+  CPU_CHAR *NamePtr;
+  OS_TCB *DbgPrevPtr;
+  OS_TCB *DbgNextPtr;
+  CPU_STK *StkBasePtr;
+  CPU_STK_SIZE StkSize;
+  OS_PRIO Prio;
+  OS_PRIO BasePrio;               // Prio before any mutex inheritance
+  OS_STATE TaskState;
+  OS_SEM_CTR SemCtr;
+  CPU_TS TS;                      // Post time handed to the pend
+  OS_CPU_USAGE CPUUsage;
+  OS_CTX_SW_CTR CtxSwCtr;
+  OS_TICK TickCtrMatch;           // Delay or pend timeout expiry
+  OS_TCB *TickNextPtr;            // Same spoke of the tick wheel
+  OS_TCB *TickPrevPtr;
+  struct os_tick_spoke *TickSpokePtr; // Spoke it is on, or NULL
+  
+  // Host only
+  pthread_t HostThread;
+  pthread_cond_t HostRun;         // Signalled when made OSTCBCurPtr
+  OS_TASK_PTR HostEntry;
+  void *HostArg;
+  void *HostPendOn;               // Object pended on, or NULL
+  OS_ERR HostPendErr;             // How the pend ended
+  CPU_INT32U HostSeq;             // Order made ready, or pended
+  CPU_SR HostPrimask;             // PRIMASK while switched out
+  CPU_INT32U HostBasepri;         // BASEPRI while switched out
+  CPU_INT64U HostCpuNs;           // Thread CPU time at the last stat
+};
+
+// Tasks whose delay or timeout ends on a tick congruent to the spoke's
+// index, modulo OSCfg_TickWheelSize, in no order
+typedef struct os_tick_spoke
+{
+  OS_TCB *FirstPtr;
+  OS_OBJ_QTY NbrEntries;
+} OS_TICK_SPOKE;
+
+typedef struct
+{
+  CPU_CHAR *NamePtr;
+  OS_SEM_CTR Ctr;
+  CPU_TS TS;
+} OS_SEM;
+
+typedef struct
+{
+  CPU_CHAR *NamePtr;
+  OS_TCB *OwnerTCBPtr;
+  OS_NESTING_CTR OwnerNestingCtr;
+  CPU_TS TS;
+} OS_MUTEX;
+
+struct os_tmr
+{
+  CPU_CHAR *NamePtr;
+  OS_TMR_CALLBACK_PTR CallbackPtr;
+  void *CallbackPtrArg;
+  OS_TMR *NextPtr;
+  OS_TICK Dly;
+  OS_TICK Period;
+  OS_TICK Remain;
+  OS_OPT Opt;
+  OS_STATE State;
+  
+  // Host only
+  CPU_INT64U HostLastNs;          // When the callback last ran
+};
+
+/*----- c o n s t a n t   d e f i n i t i o n s -----*/
+
+#define OS_TASK_STATE_RDY 0u
+#define OS_TASK_STATE_DLY 1u
+#define OS_TASK_STATE_PEND 2u
+#define OS_TASK_STATE_PEND_TIMEOUT 3u
+#define OS_TASK_STATE_DEL 255u
+
+#define OS_TMR_STATE_UNUSED 0u
+#define OS_TMR_STATE_STOPPED 1u
+#define OS_TMR_STATE_RUNNING 2u
+
+#define OS_OPT_NONE 0x0000u
+#define OS_OPT_PEND_BLOCKING 0x0000u
+#define OS_OPT_PEND_NON_BLOCKING 0x8000u
+#define OS_OPT_POST_1 0x0000u
+#define OS_OPT_POST_ALL 0x0200u
+#define OS_OPT_POST_NONE 0x0000u
+#define OS_OPT_POST_NO_SCHED 0x8000u
+#define OS_OPT_TASK_NONE 0x0000u
+#define OS_OPT_TASK_STK_CHK 0x0001u
+#define OS_OPT_TASK_STK_CLR 0x0002u
+#define OS_OPT_TIME_DLY 0x0000u
+#define OS_OPT_TMR_ONE_SHOT 0x0002u
+#define OS_OPT_TMR_PERIODIC 0x0003u
+
+#define OS_ERR_NONE 0u
+#define OS_ERR_INT_Q_FULL 19001u
+#define OS_ERR_MUTEX_NOT_OWNER 22401u
+#define OS_ERR_MUTEX_OWNER 22402u
+#define OS_ERR_OPT_INVALID 24001u
+#define OS_ERR_PEND_ISR 25002u
+#define OS_ERR_PEND_WOULD_BLOCK 25004u
+#define OS_ERR_SCHED_LOCKED 25402u
+#define OS_ERR_TASK_DEL_INVALID 27209u
+#define OS_ERR_TIMEOUT 29401u
+
+/*----- g l o b a l    v a r i a b l e s -----*/
+
+extern OS_TCB *OSTCBCurPtr;
+extern OS_TCB *OSTCBHighRdyPtr;
+extern OS_TCB *OSTaskDbgListPtr;
+extern OS_NESTING_CTR OSIntNestingCtr;
+extern OS_NESTING_CTR OSSchedLockNestingCtr;
+extern OS_CTX_SW_CTR OSTaskCtxSwCtr;
+extern OS_TICK OSTickCtr;
+extern OS_CTR OSTmrUpdateCtr;     // Ticks until the timer task runs
+extern OS_CPU_USAGE OSStatTaskCPUUsage;
+extern CPU_BOOLEAN OSRunning;
+
+extern OS_TCB OSIdleTaskTCB;
+extern OS_TCB OSStatTaskTCB;
+extern OS_TCB OSTmrTaskTCB;
+
+#if OS_CFG_ISR_POST_DEFERRED_EN > 0u
+extern OS_TCB OSIntQTaskTCB;
+extern OS_OBJ_QTY OSIntQNbrEntries;
+extern OS_OBJ_QTY OSIntQNbrEntriesMax;
+extern OS_OBJ_QTY OSIntQOvfCtr;     // Posts lost to a full queue
+#endif
+
+extern const OS_TICK OSCfg_TickRate_Hz;
+extern OS_TICK_SPOKE OSCfg_TickWheel[];
+extern const OS_OBJ_QTY OSCfg_TickWheelSize;
+
+extern OS_APP_HOOK_TCB OS_AppTaskCreateHookPtr;
+extern OS_APP_HOOK_TCB OS_AppTaskDelHookPtr;
+extern OS_APP_HOOK_TCB OS_AppTaskReturnHookPtr;
+extern OS_APP_HOOK_VOID OS_AppIdleTaskHookPtr;
+extern OS_APP_HOOK_VOID OS_AppStatTaskHookPtr;
+extern OS_APP_HOOK_VOID OS_AppTaskSwHookPtr;
+extern OS_APP_HOOK_VOID OS_AppTimeTickHookPtr;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void OSInit(OS_ERR *p_err);
+void OSStart(OS_ERR *p_err);
+void OSSched(void);
+void OSSchedLock(OS_ERR *p_err);
+void OSSchedUnlock(OS_ERR *p_err);
+void OSIntEnter(void);
+void OSIntExit(void);
+
+void OSTaskCreate(OS_TCB *p_tcb,CPU_CHAR *p_name,OS_TASK_PTR p_task,
+                  void *p_arg,OS_PRIO prio,CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit,CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size,OS_TICK time_quanta,void *p_ext,
+                  OS_OPT opt,OS_ERR *p_err);
+void OSTaskDel(OS_TCB *p_tcb,OS_ERR *p_err);
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                         OS_ERR *p_err);
+OS_SEM_CTR OSTaskSemPost(OS_TCB *p_tcb,OS_OPT opt,OS_ERR *p_err);
+void OSTaskStkChk(OS_TCB *p_tcb,CPU_STK_SIZE *p_free,CPU_STK_SIZE *p_used,
+                  OS_ERR *p_err);
+
+void OSSemCreate(OS_SEM *p_sem,CPU_CHAR *p_name,OS_SEM_CTR cnt,
+                 OS_ERR *p_err);
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem,OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                     OS_ERR *p_err);
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem,OS_OPT opt,OS_ERR *p_err);
+
+void OSMutexCreate(OS_MUTEX *p_mutex,CPU_CHAR *p_name,OS_ERR *p_err);
+void OSMutexPend(OS_MUTEX *p_mutex,OS_TICK timeout,OS_OPT opt,CPU_TS *p_ts,
+                 OS_ERR *p_err);
+void OSMutexPost(OS_MUTEX *p_mutex,OS_OPT opt,OS_ERR *p_err);
+
+OS_TICK OSTimeGet(OS_ERR *p_err);
+void OSTimeDly(OS_TICK dly,OS_OPT opt,OS_ERR *p_err);
+void OSTimeTick(void);
+
+void OSTmrCreate(OS_TMR *p_tmr,CPU_CHAR *p_name,OS_TICK dly,OS_TICK period,
+                 OS_OPT opt,OS_TMR_CALLBACK_PTR p_callback,
+                 void *p_callback_arg,OS_ERR *p_err);
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr,OS_ERR *p_err);
+
+void OSStatTaskCPUUsageInit(OS_ERR *p_err);
+
+// os_cpu.h
+void OS_CPU_SysTickInit(CPU_INT32U cnts);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __stm32f10x_lib__
+#define __stm32f10x_lib__
+/*--------------- s t m 3 2 f 1 0 x _ l i b . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the ST firmware library: the peripheral map and the
+library's bool.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <stm32f10x_map.h>
+
+typedef enum {FALSE = 0, TRUE = !FALSE} bool;
+
+#endif
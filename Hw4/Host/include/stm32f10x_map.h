@@ -0,0 +1,54 @@
+#ifndef __stm32f10x_map__
+#define __stm32f10x_map__
+/*--------------- s t m 3 2 f 1 0 x _ m a p . h ---------------*/
+
+/*
+PURPOSE
+Host stand-in for the ST peripheral map. USART2 is the simulated
+register block in HostUart.c; GPIOD is plain memory, as a host build
+replaces the RTS macros that use it.
+
+CHANGES
+10-19-2026 dwt - File Created
+*/
+#include <stdint.h>
+
+typedef volatile uint16_t vu16;
+typedef volatile uint32_t vu32;
+
+typedef struct
+{
+  vu16 SR;
+  uint16_t RESERVED0;
+  vu16 DR;
+  uint16_t RESERVED1;
+  vu16 BRR;
+  uint16_t RESERVED2;
+  vu16 CR1;
+  uint16_t RESERVED3;
+  vu16 CR2;
+  uint16_t RESERVED4;
+  vu16 CR3;
+  uint16_t RESERVED5;
+  vu16 GTPR;
+  uint16_t RESERVED6;
+} USART_TypeDef;
+
+typedef struct
+{
+  vu32 CRL;
+  vu32 CRH;
+  vu32 IDR;
+  vu32 ODR;
+  vu32 BSRR;
+  vu32 BRR;
+  vu32 LCKR;
+} GPIO_TypeDef;
+
+extern USART_TypeDef hostUsart2;
+extern GPIO_TypeDef hostGpiod;
+
+#define USART2 (&hostUsart2)
+#define GPIOD (&hostGpiod)
+
+#endif
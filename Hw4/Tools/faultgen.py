@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""faultgen.py - measure how ParsePkt recovers from a corrupted stream
+
+by: David Tyler
+
+PURPOSE
+Generate a stream of good frames, corrupt it from a seed, run it through
+the host build and count what came out. Each frame is a solar radiation
+reading whose source and value together are unique in the stream, so
+every message shown can be matched to the frame it came from; the value
+changes on every frame from a node, so NodeTable.c never holds one back.
+
+The gateway runs lossless (-l), which makes the parser's output depend
+only on the bytes: a seed always gives the same counts. Only the CPU
+figure varies from run to run. RX bytes are spaced (-g) so TX keeps up;
+a run where the TX queue shed anything is an error, as the missing
+messages would count against the parser.
+
+For each seed it reports
+  offered      frames generated, and how many were corrupted: had
+               their own bytes altered
+  delivered    intact frames shown
+  false        messages shown that no intact frame sent: corrupted
+               frames that passed, or frames made up from noise
+  resync       bytes from each fault to the start of the next intact
+               frame shown, mean and max
+  lost         intact frames not shown, the cost of resyncing
+  parse        Parse Task CPU per RX byte
+
+A fault is where a corrupted frame's first altered byte is, or where
+noise was put between frames: a false preamble, or a byte inserted
+after a frame's last byte. Noise leaves the frames around it intact.
+
+CORRUPTION
+Rates are per byte for flips, drops and inserts, and per frame for the
+rest:
+  -F  flip one bit of a byte
+  -D  drop a byte
+  -I  insert a random byte after a byte; after a frame's last byte it
+      is noise between frames
+  -T  truncate a frame at a random point
+  -P  put a false preamble, 03 EF AF and a random byte, before a frame,
+      as noise between frames
+  -L  replace a frame's length with a random wrong one
+
+USAGE
+  faultgen.py -x ../Host/gateway                  seeds 1 2 3, defaults
+  faultgen.py -x ../Host/gateway -S 7 -n 5000 -F 0.001
+  faultgen.py -x ../Host/gateway -W faults.base   record a baseline
+  faultgen.py -x ../Host/gateway -B faults.base   fail on a regression
+  faultgen.py -x ../Host/gateway -g 50            slower RX (default 20 us)
+
+A regression is fewer frames delivered, more false accepts or a longer
+mean resync than the baseline for the same seed and settings. CPU is
+reported but not gated; it varies too much between hosts.
+
+CHANGES
+10-19-2026 dwt - File Created
+10-19-2026 dwt - Only a frame's own altered bytes corrupt it; resync is
+                 measured from each fault
+"""
+
+import argparse
+import bisect
+import json
+import random
+import re
+import subprocess
+import sys
+import tempfile
+
+import pktgen
+
+FIRST_SRC = 2
+NUM_SRCS = 8
+HEADER = re.compile(r"^SOURCE NODE (\d+): SOLAR RADIATION MESSAGE / "
+                    r"Solar Radiation Intensity = (\d+)$")
+
+
+def goodFrames(n):
+    """n frames, as (key, bytes); key is (src, value)."""
+    frames = []
+    for seq in range(n):
+        src = FIRST_SRC + seq % NUM_SRCS
+        value = seq & 0xFFFF
+        tokens = [str(src), "rad", "%04X" % value]
+        frames.append(((src, value), pktgen.frame(tokens, "frame %d" % seq)))
+    return frames
+
+
+def corrupt(frames, rng, args):
+    """Build the stream; return (bytes, [(key, start, intact)], faults),
+    faults being the stream offsets of the faults."""
+    out, index, faults = bytearray(), [], []
+    for key, pkt in frames:
+        if rng.random() < args.preamble:
+            faults.append(len(out))
+            out += pktgen.PREAMBLE + bytes([rng.randrange(256)])
+        start = len(out)
+        first = None        # offset of the frame's first altered byte
+        pkt = bytearray(pkt)
+        lengthHit = rng.random() < args.length
+        if lengthHit:
+            pkt[3] = (pkt[3] + rng.randrange(1, 256)) & 0xFF
+        truncated = rng.random() < args.truncate
+        if truncated:
+            del pkt[rng.randrange(1, len(pkt)):]
+        for i, b in enumerate(pkt):
+            if first is None and lengthHit and i == 3:
+                first = len(out)
+            if rng.random() < args.drop:
+                if first is None:
+                    first = len(out)
+                continue
+            if rng.random() < args.flip:
+                b ^= 1 << rng.randrange(8)
+                if first is None:
+                    first = len(out)
+            out.append(b)
+            if rng.random() < args.insert:
+                if i == len(pkt) - 1:
+                    faults.append(len(out))
+                elif first is None:
+                    first = len(out)
+                out.append(rng.randrange(256))
+        # a frame cut short goes wrong where its next byte should be
+        if first is None and truncated:
+            first = len(out)
+        if first is not None:
+            faults.append(first)
+        index.append((key, start, first is None))
+    # push the last frame out of a 4 byte RX buffer, as in pkts.txt
+    out += pktgen.PREAMBLE
+    return bytes(out), index, sorted(faults)
+
+
+def run(exe, stream, gap):
+    """Run the lossless host build; return (stdout, stderr)."""
+    with tempfile.NamedTemporaryFile(suffix=".dat") as f:
+        f.write(stream)
+        f.flush()
+        p = subprocess.run([exe, "-l", "-g", str(gap), "-q", "200", f.name],
+                           capture_output=True)
+    err = p.stderr.decode("latin-1")
+    m = re.search(r"shed (\d+) oldest (\d+) new (\d+) summarized", err)
+    if m is None:
+        sys.exit("faultgen: no summary from %s" % exe)
+    if any(int(n) for n in m.groups()):
+        sys.exit("faultgen: the TX queue shed messages; raise -g")
+    return p.stdout.decode("latin-1"), err
+
+
+def measure(index, faults, out, err, nBytes):
+    """Count what came out against what went in."""
+    shown = []
+    for rec in pktgen.records(out.splitlines()):
+        if pktgen.ERROR.match(rec):
+            continue
+        m = HEADER.match(rec)
+        shown.append((int(m.group(1)), int(m.group(2))) if m else rec)
+
+    intact = {key for key, _, ok in index if ok}
+    shownSet = set(shown)
+    delivered = sum(1 for key in intact if key in shownSet)
+    # shown but matching no frame, or only a corrupted one
+    false = sum(1 for key in shown if key not in intact)
+
+    # from each fault to the next intact frame shown
+    starts = [start for key, start, ok in index if ok and key in shownSet]
+    resyncs = []
+    for pos in faults:
+        i = bisect.bisect_right(starts, pos)
+        if i < len(starts):
+            resyncs.append(starts[i] - pos)
+
+    m = re.search(r"HOST RX: \d+ offered, (\d+) read", err)
+    read = int(m.group(1)) if m else nBytes
+    m = re.search(r"^\s+Parse Task\s+([\d.]+)", err, re.M)
+    parseNs = float(m.group(1)) * 1e6 / read if m and read else None
+
+    return {"offered": len(index),
+            "corrupted": sum(1 for _, _, ok in index if not ok),
+            "delivered": delivered,
+            "false": false,
+            "resyncMean": round(sum(resyncs) / len(resyncs), 1)
+                          if resyncs else 0.0,
+            "resyncMax": max(resyncs) if resyncs else 0,
+            "lost": len(intact) - delivered,
+            "parseNsPerByte": parseNs}
+
+
+def settings(args):
+    return "n=%d F=%g D=%g I=%g T=%g P=%g L=%g" % (
+        args.frames, args.flip, args.drop, args.insert, args.truncate,
+        args.preamble, args.length)
+
+
+def regressions(got, base):
+    out = []
+    if got["delivered"] < base["delivered"]:
+        out.append("delivered %d < %d" % (got["delivered"], base["delivered"]))
+    if got["false"] > base["false"]:
+        out.append("false accepts %d > %d" % (got["false"], base["false"]))
+    if got["resyncMean"] > base["resyncMean"]:
+        out.append("resync mean %.1f > %.1f" %
+                   (got["resyncMean"], base["resyncMean"]))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description="parser fault injection")
+    ap.add_argument("-x", dest="exe", required=True)
+    ap.add_argument("-S", type=int, action="append", dest="seeds")
+    ap.add_argument("-n", type=int, default=2000, dest="frames")
+    ap.add_argument("-g", type=int, default=20, dest="gap")
+    ap.add_argument("-F", type=float, default=0.002, dest="flip")
+    ap.add_argument("-D", type=float, default=0.002, dest="drop")
+    ap.add_argument("-I", type=float, default=0.002, dest="insert")
+    ap.add_argument("-T", type=float, default=0.01, dest="truncate")
+    ap.add_argument("-P", type=float, default=0.01, dest="preamble")
+    ap.add_argument("-L", type=float, default=0.01, dest="length")
+    gate = ap.add_mutually_exclusive_group()
+    gate.add_argument("-W", dest="write")
+    gate.add_argument("-B", dest="base")
+    args = ap.parse_args()
+    if args.frames > 0x10000:
+        sys.exit("faultgen: at most 65536 frames")
+    seeds = args.seeds or [1, 2, 3]
+
+    base = {}
+    if args.base:
+        with open(args.base) as f:
+            base = json.load(f)
+        if base.get("settings") != settings(args):
+            sys.exit("faultgen: %s was made with %s" %
+                     (args.base, base.get("settings")))
+
+    frames = goodFrames(args.frames)
+    results, failed = {}, False
+    print("seed  offered corrupt delivered false  resync mean/max  lost"
+          "  parse ns/byte")
+    for seed in seeds:
+        stream, index, faults = corrupt(frames, random.Random(seed), args)
+        out, err = run(args.exe, stream, args.gap)
+        r = measure(index, faults, out, err, len(stream))
+        results[str(seed)] = r
+        print("%4d %8d %7d %9d %5d %10.1f/%-5d %5d %14s" % (
+            seed, r["offered"], r["corrupted"], r["delivered"], r["false"],
+            r["resyncMean"], r["resyncMax"], r["lost"],
+            "%.0f" % r["parseNsPerByte"] if r["parseNsPerByte"] else "-"))
+        if str(seed) in base.get("seeds", {}):
+            bad = regressions(r, base["seeds"][str(seed)])
+            for b in bad:
+                print("  seed %d regressed: %s" % (seed, b))
+            failed = failed or bool(bad)
+
+    if args.write:
+        for r in results.values():
+            del r["parseNsPerByte"]
+        with open(args.write, "w") as f:
+            json.dump({"settings": settings(args), "seeds": results}, f,
+                      indent=1, sort_keys=True)
+            f.write("\n")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,413 @@
+#!/usr/bin/env python3
+"""pktgen.py - replay packet scenarios into the gateway and check the output
+
+by: David Tyler
+
+PURPOSE
+Build the byte stream for a packet description file, send it to the
+gateway with the given spacing, and compare what comes back with the
+golden runs in TESTS.txt. This stands in for the generator behind the
+"Packet File Name" and "Delay Factor" prompts there.
+
+The stream goes to the host build (Hw4/Host/gateway), to a serial port
+or pty, or to stdout as a .dat file. Spacing is in byte times at the
+line rate: after each byte the line idles for the delay factor's worth
+of byte times, and after each frame for the frame delay's. Delay
+factor 0 with no frame delay is a back to back stream.
+
+DESCRIPTION FILES
+One item per line; # starts a comment.
+
+  <src> <type> <data>... [dst=N] [pre=HHHHHH] [len=N] [cs=HH]
+      A frame: preamble 03 EF AF, length, dst (default 1), src, type,
+      data and the XOR checksum. type is a number or one of temp, baro,
+      hum, wind, rad, time, precip, id. data are hex bytes or "text".
+      pre, len and cs replace the computed fields, to make bad frames.
+  raw <hex>...
+      Bytes sent as they are.
+  idle <n>
+      n more byte times of idle line.
+
+COMPARING
+Only the kinds of line TESTS.txt records are compared: each SOURCE
+NODE header with its value line, and *** ERROR lines; alerts and
+reports are left out. Errors now go through the log task, which sends
+them a little late, so they are compared as a set after the
+messages. A message TESTS.txt shows that NodeTable.c now suppresses, a
+reading equal to the last one shown from its node, is dropped from the
+golden run first. A scenario passes if it matches any
+golden run of its packet file (pkts.txt goes with pkts.dat), as some
+runs there were cut short or split across the prompts.
+
+USAGE
+  pktgen.py pkts.txt > pkts.dat                write the stream
+  pktgen.py -x ../Host/gateway pkts.txt        run the host build
+  pktgen.py -p /dev/ttyUSB0 pkts.txt           drive a port
+  pktgen.py -x ../Host/gateway -s 8 errs.txt   sweep DF 8, 4, 2, 1, 0
+
+  -d DF      idle byte times after each byte (default 4)
+  -f N       idle byte times after each frame (default 0)
+  -b baud    line rate, 10 bits a byte (default 9600)
+  -s DF      sweep the delay factor down from DF to 0, halving, and
+             report the lowest that matches
+  -q ms      quiet time that ends a run (default 500)
+  -g file    golden text (default ../TESTS.txt)
+
+CHANGES
+10-19-2026 dwt - File Created
+"""
+
+import argparse
+import difflib
+import os
+import re
+import shlex
+import subprocess
+import sys
+import threading
+import time
+
+PREAMBLE = bytes([0x03, 0xEF, 0xAF])
+DEST_ADDR = 1
+TYPES = {"temp": 1, "baro": 2, "hum": 3, "wind": 4, "rad": 5, "time": 6,
+         "precip": 7, "id": 8}
+BITS_PER_BYTE = 10
+
+HEADER = re.compile(r"^\s*SOURCE NODE (\d+): (.*)$")
+ERROR = re.compile(r"^\s*\*\*\* ERROR: ")
+# Readings NodeTable.c always sends
+UNTRACKED = ("DATE/TIME STAMP MESSAGE", "SENSOR ID MESSAGE")
+
+
+def hexBytes(text, where):
+    try:
+        return bytes.fromhex(text)
+    except ValueError:
+        sys.exit("pktgen: %s: bad hex %r" % (where, text))
+
+
+def number(text, where):
+    try:
+        return int(text, 0) if text.lower().startswith("0x") else int(text)
+    except ValueError:
+        sys.exit("pktgen: %s: bad number %r" % (where, text))
+
+
+def frame(tokens, where):
+    """Build one frame from a description line's tokens."""
+    opts = dict(t.split("=", 1) for t in tokens if "=" in t)
+    words = [t for t in tokens if "=" not in t]
+    if len(words) < 2:
+        sys.exit("pktgen: %s: need a source and a type" % where)
+    src = number(words[0], where)
+    msgType = TYPES.get(words[1].lower())
+    if msgType is None:
+        msgType = number(words[1], where)
+    data = b""
+    for w in words[2:]:
+        if w[0] == '"' and w[-1] == '"' and len(w) >= 2:
+            data += w[1:-1].encode()
+        else:
+            data += hexBytes(w, where)
+
+    pre = hexBytes(opts["pre"], where) if "pre" in opts else PREAMBLE
+    dst = number(opts["dst"], where) if "dst" in opts else DEST_ADDR
+    body = bytes([dst, src, msgType]) + data
+    if "len" in opts:
+        length = number(opts["len"], where)
+    else:
+        length = len(pre) + len(body) + 2
+    pkt = pre + bytes([length & 0xFF]) + body
+    cs = 0
+    for b in pkt:
+        cs ^= b
+    if "cs" in opts:
+        cs = hexBytes(opts["cs"], where)[0]
+    return pkt + bytes([cs])
+
+
+def readDesc(path):
+    """Return [(bytes, idle byte times before them)] frame by frame."""
+    items, idle = [], 0
+    with open(path) as f:
+        for n, line in enumerate(f, 1):
+            where = "%s:%d" % (path, n)
+            tokens = shlex.split(line, comments=True, posix=False)
+            if not tokens:
+                continue
+            if tokens[0] == "idle":
+                idle += number(tokens[1], where)
+            elif tokens[0] == "raw":
+                items.append((hexBytes("".join(tokens[1:]), where), idle))
+                idle = 0
+            else:
+                items.append((frame(tokens, where), idle))
+                idle = 0
+    return items
+
+
+def schedule(items, df, frameDelay):
+    """Return [(time in byte times, bytes)], a run of bytes at a time.
+
+    Bytes with no idle line between them go out together; the gateway or
+    the UART paces them at the line rate.
+    """
+    runs, t = [], 0
+    for pkt, idle in items:
+        t += idle
+        if df == 0:
+            runs.append((t, pkt))
+            t += len(pkt)
+        else:
+            for b in pkt:
+                runs.append((t, bytes([b])))
+                t += 1 + df
+        t += frameDelay
+    return runs
+
+
+def send(write, runs, byteSec):
+    """Write each run of bytes when it is due."""
+    start = time.monotonic()
+    for t, data in runs:
+        wait = start + t * byteSec - time.monotonic()
+        if wait > 0:
+            time.sleep(wait)
+        write(data)
+
+
+def ordered(recs):
+    """Messages in order, then the errors sorted."""
+    return ([r for r in recs if not ERROR.match(r)] +
+            sorted(r for r in recs if ERROR.match(r)))
+
+
+def records(lines):
+    """The compared lines: 'header / value' per message, and errors."""
+    out, header = [], None
+    for line in lines:
+        line = line.replace("\a", "").rstrip()
+        if not line.strip():
+            continue
+        if HEADER.match(line):
+            header = line.strip()
+        elif ERROR.match(line):
+            out.append(line.strip())
+            header = None
+        elif header is not None and line.startswith("   "):
+            out.append(header + " / " + line.strip())
+            header = None
+        else:
+            header = None
+    return ordered(out)
+
+
+def goldenRuns(path):
+    """Parse TESTS.txt into runs of {file, df, buf, recs}.
+
+    Output that came out after a prompt is glued back onto the value it
+    was cut from, as in "12." then "34".
+    """
+    runs, cur, last, header, buf = [], None, None, None, "4"
+    with open(path, errors="replace") as f:
+        for raw in f:
+            line = raw.replace("\a", "").rstrip()
+            s = line.strip()
+            m = re.match(r"I/O Buffer (\d+)", s)
+            if m:
+                buf = m.group(1)
+                continue
+            m = re.match(r"Packet File Name \[(.*?)\].*quit:\s*(\S*)", s)
+            if m:
+                name = m.group(2) or m.group(1)
+                cur = None
+                if name != ".":
+                    cur = {"file": name, "df": None, "buf": buf, "recs": []}
+                    runs.append(cur)
+                header = None
+                continue
+            m = re.match(r"Delay Factor \[DF=(\d+)\].*quit:\s*(\S*)", s)
+            if m and cur is not None:
+                cur["df"] = m.group(2) or m.group(1)
+                continue
+            if not s or s.startswith("-") or "DF=" in s:
+                continue
+            if HEADER.match(line):
+                header = s
+            elif ERROR.match(line):
+                if cur is not None:
+                    cur["recs"].append([s])
+                header = None
+            elif header is not None and line.startswith("   "):
+                if cur is not None:
+                    last = [header, s]
+                    cur["recs"].append(last)
+                header = None
+            elif last is not None:
+                last[1] += s
+    for run in runs:
+        run["recs"] = [" / ".join(r) for r in run["recs"]]
+    return [r for r in runs if r["recs"]]
+
+
+def suppress(recs):
+    """Drop the repeats NodeTable.c doesn't send."""
+    out, shown = [], {}
+    for r in recs:
+        m = HEADER.match(r)
+        if m and not m.group(2).split(" / ")[0] in UNTRACKED:
+            key = (m.group(1), m.group(2).split(" / ")[0])
+            if shown.get(key) == r:
+                continue
+            shown[key] = r
+        out.append(r)
+    return out
+
+
+def runHost(exe, runs, byteSec, quietMs):
+    """Run the host build on the stream; return (stdout, summary)."""
+    us = str(max(1, int(byteSec * 1e6)))
+    p = subprocess.Popen([exe, "-g", us, "-t", us, "-q", str(quietMs)],
+                         stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                         stderr=subprocess.PIPE)
+    got = {}
+
+    def drain(name, pipe):
+        got[name] = pipe.read()
+
+    readers = [threading.Thread(target=drain, args=(n, pipe))
+               for n, pipe in (("out", p.stdout), ("err", p.stderr))]
+    for r in readers:
+        r.start()
+    try:
+        send(lambda data: (p.stdin.write(data), p.stdin.flush()), runs,
+             byteSec)
+        p.stdin.close()
+    except BrokenPipeError:
+        pass
+    for r in readers:
+        r.join()
+    p.wait()
+    return got["out"].decode("latin-1"), got["err"].decode("latin-1")
+
+
+def runPort(port, runs, byteSec, baud, quietMs):
+    """Drive a serial port or pty; return what came back."""
+    import termios
+    import tty
+
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    speed = getattr(termios, "B%d" % baud, None)
+    if speed is not None:
+        attrs = termios.tcgetattr(fd)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    got, done = [], threading.Event()
+
+    def drain():
+        import select
+        quietSince = None
+        while True:
+            ready, _, _ = select.select([fd], [], [], 0.05)
+            if ready:
+                got.append(os.read(fd, 4096))
+                quietSince = None
+            elif done.is_set():
+                quietSince = quietSince or time.monotonic()
+                if time.monotonic() - quietSince >= quietMs / 1000:
+                    return
+
+    reader = threading.Thread(target=drain)
+    reader.start()
+    send(lambda data: os.write(fd, data), runs, byteSec)
+    done.set()
+    reader.join()
+    os.close(fd)
+    return b"".join(got).decode("latin-1"), ""
+
+
+def compare(got, golden, file):
+    """Return (matching run or None, closest run, diff lines)."""
+    runs = [r for r in golden if r["file"] == file]
+    if not runs:
+        sys.exit("pktgen: no golden run of %s" % file)
+    best = None
+    for r in runs:
+        want = ordered(suppress(r["recs"]))
+        diff = list(difflib.unified_diff(want, got, "golden", "got",
+                                         lineterm="", n=1))
+        if not diff:
+            return r, r, []
+        if best is None or len(diff) < len(best[1]):
+            best = (r, diff)
+    return None, best[0], best[1]
+
+
+def lost(summary):
+    m = re.search(r"HOST RX: .* (\d+) lost", summary)
+    return m.group(1) if m else None
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description="packet replay and check")
+    ap.add_argument("desc")
+    ap.add_argument("-d", type=int, default=4, dest="df")
+    ap.add_argument("-f", type=int, default=0, dest="frameDelay")
+    ap.add_argument("-b", type=int, default=9600, dest="baud")
+    ap.add_argument("-s", type=int, dest="sweep")
+    ap.add_argument("-q", type=int, default=500, dest="quietMs")
+    ap.add_argument("-g", default=os.path.join(here, "..", "TESTS.txt"),
+                    dest="golden")
+    target = ap.add_mutually_exclusive_group()
+    target.add_argument("-x", dest="exe")
+    target.add_argument("-p", dest="port")
+    args = ap.parse_args()
+
+    items = readDesc(args.desc)
+    byteSec = BITS_PER_BYTE / args.baud
+    if not args.exe and not args.port:
+        sys.stdout.buffer.write(b"".join(pkt for pkt, _ in items))
+        return
+
+    golden = goldenRuns(args.golden)
+    file = os.path.splitext(os.path.basename(args.desc))[0] + ".dat"
+    dfs = [args.df]
+    if args.sweep is not None:
+        dfs, df = [], args.sweep
+        while df > 0:
+            dfs.append(df)
+            df //= 2
+        dfs.append(0)
+
+    lowest = None
+    for df in dfs:
+        runs = schedule(items, df, args.frameDelay)
+        if args.exe:
+            out, summary = runHost(args.exe, runs, byteSec, args.quietMs)
+        else:
+            out, summary = runPort(args.port, runs, byteSec, args.baud,
+                                   args.quietMs)
+        match, closest, diff = compare(records(out.splitlines()), golden,
+                                       file)
+        note = ", RX lost %s" % lost(summary) if lost(summary) else ""
+        if match:
+            print("DF %d: pass, as golden %s DF=%s buffer %s%s" %
+                  (df, file, match["df"], match["buf"], note))
+            lowest = df
+            continue
+        print("DF %d: FAIL against golden %s DF=%s buffer %s%s" %
+              (df, file, closest["df"], closest["buf"], note))
+        for line in diff:
+            print("  " + line)
+        break
+
+    if args.sweep is not None:
+        print("lowest delay factor sustained: %s" %
+              (lowest if lowest is not None else "none"))
+    sys.exit(0 if lowest is not None else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""trace2json.py - convert a gateway context switch trace dump to a timeline
+
+by: David Tyler
+
+PURPOSE
+Read the text the gateway sends for a CmdTraceDump command (captured
+from the serial port, other output may be mixed in) and write Chrome
+trace event JSON, which chrome://tracing and ui.perfetto.dev show as
+one row per task.
+
+USAGE
+  trace2json.py capture.txt > trace.json
+  trace2json.py < capture.txt > trace.json
+
+CHANGES
+10-19-2026 dwt - File Created
+"""
+
+import json
+import sys
+
+
+def parse(lines):
+    """Return (timestamp Hz, {tcb: name}, [(ts, from, to)]) of the last dump."""
+    hz, names, switches = None, {}, []
+    inDump = False
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        if fields[0] == "TRACE" and len(fields) == 3:
+            hz, names, switches = int(fields[2]), {}, []
+            inDump = True
+        elif not inDump:
+            continue
+        elif fields[0] == "TRACE" and fields[1:] == ["END"]:
+            inDump = False
+        elif fields[0] == "T" and len(fields) >= 2:
+            names[fields[1]] = " ".join(fields[2:]) or fields[1]
+        elif fields[0] == "S" and len(fields) == 4:
+            switches.append((int(fields[1]), fields[2], fields[3]))
+    if hz is None:
+        sys.exit("trace2json: no TRACE dump found")
+    return hz, names, switches
+
+
+def unwrap(switches):
+    """Make the 32 bit timestamps monotonic."""
+    out, base, last = [], 0, None
+    for ts, frm, to in switches:
+        if last is not None and ts < last:
+            base += 1 << 32
+        last = ts
+        out.append((base + ts, frm, to))
+    return out
+
+
+def events(hz, names, switches):
+    """One complete event per run of a task, from switch in to switch out."""
+    usPerTick = 1e6 / hz if hz else 1.0
+    tids = {}
+
+    def tid(tcb):
+        if tcb not in tids:
+            tids[tcb] = len(tids) + 1
+        return tids[tcb]
+
+    evs = []
+    for (ts, _, to), (nextTs, _, _) in zip(switches, switches[1:]):
+        evs.append({"name": names.get(to, to), "ph": "X", "pid": 1,
+                    "tid": tid(to), "ts": ts * usPerTick,
+                    "dur": (nextTs - ts) * usPerTick})
+    for tcb, n in tids.items():
+        evs.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": n,
+                    "args": {"name": names.get(tcb, tcb)}})
+    return evs
+
+
+def main():
+    src = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+    hz, names, switches = parse(src)
+    json.dump({"traceEvents": events(hz, names, unwrap(switches)),
+               "displayTimeUnit": "ms"}, sys.stdout, indent=1)
+
+
+if __name__ == "__main__":
+    main()